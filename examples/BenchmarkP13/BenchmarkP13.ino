@@ -0,0 +1,300 @@
+/* ====================================================================
+
+   Copyright (c) 2019-2021 Thorsten Godau (https://github.com/dl9sec)
+   All rights reserved.
+
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+
+   3. Neither the name of the author(s) nor the names of any contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR(S) AND CONTRIBUTORS "AS IS" AND
+   ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR(S) OR CONTRIBUTORS BE LIABLE
+   FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+   DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+   OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+   OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+   SUCH DAMAGE.
+
+   ====================================================================*/
+
+
+// Benchmark for the hot paths of the library. Comparing the results of this
+// sketch before and after a change shows performance regressions.
+//
+// Runs on the boards as a normal sketch (results to Serial) and on a PC without
+// the Arduino core (results to stdout):
+//
+//   g++ -O2 -x c++ -Isrc examples/BenchmarkP13/BenchmarkP13.ino -x none src/AioP13.cpp -o benchmark
+
+#include <AioP13.h>
+
+#ifndef ARDUINO
+  #include <chrono>
+
+  static unsigned long micros()
+  {
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+#endif
+
+#ifdef __AVR__
+  #define BENCH_N   100          // Number of calls per measurement
+#elif defined(ARDUINO)
+  #define BENCH_N   2000
+#else
+  #define BENCH_N   200000
+#endif
+
+// Fixtures: low, medium and high earth orbit (high eccentricity) and geostationary
+const char *tleFixtures[][3] = {
+  { "ISS (ZARYA) LEO",  "1 25544U 98067A   21320.51955234  .00001288  00000+0  31985-4 0  9990",
+                        "2 25544  51.6447 309.4881 0004694 203.6966 299.8876 15.48582035312205" },
+  { "GPS BIIR-2 MEO",   "1 24876U 97035A   21320.43802679 -.00000034  00000+0  00000+0 0  9994",
+                        "2 24876  55.5703 183.4164 0049805  51.6689 308.7904  2.00563379177777" },
+  { "MOLNIYA 1-91 HEO", "1 25485U 98054A   21320.21053930  .00000081  00000-0  00000-0 0  9990",
+                        "2 25485  64.0883  11.9585 6941392 290.3884  11.8632  2.36434930169823" },
+  { "ES'HAIL 2 GEO",    "1 43700U 18090A   21320.51254296  .00000150  00000+0  00000+0 0  9998",
+                        "2 43700   0.0138 278.3980 0002418 337.0092  10.7288  1.00272495 10898" }
+};
+
+const int    iFixtures = sizeof(tleFixtures) / sizeof(tleFixtures[0]);
+
+const char  *pcMyName  = "DL9SEC";   // Observer name
+double       dMyLAT    =  48.661563; // Latitude (Breitengrad): N -> +, S -> -
+double       dMyLON    =   9.779416; // Longitude (Längengrad): E -> +, W -> -
+double       dMyALT    = 386.0;      // Altitude ASL (m)
+
+double       dStep     = 10.0 / 86400.0;  // Time step between predictions (10 s)
+
+int          aiFP[90][2];            // Array for the footprint map coordinates
+uint8_t      auFPBreak[90];          // Date line breaks of the footprint
+P13Real      adCircle[90][2];        // Cached unit circle for P13Footprint
+char         acTime[P13DateTime::ascii_str_len + 1];   // Buffer for ASCII time
+#ifndef __AVR__
+double       adMoonEL[1440];         // Moon table over a day (not enough RAM on AVR)
+double       adMoonAZ[1440];         // -"-
+#endif
+
+volatile double dSink  = 0;          // Keeps the compiler from removing the calls
+
+// Prints one result line: name of the measurement, fixture, calls and time per call
+void report(const char *p_ccname, const char *p_ccfixture, unsigned long p_ulcalls, unsigned long p_ulus)
+{
+  #ifdef ARDUINO
+    Serial.print(p_ccname);
+    Serial.print("\t");
+    Serial.print(p_ccfixture);
+    Serial.print("\t");
+    Serial.print(p_ulcalls);
+    Serial.print(" calls\t");
+    Serial.print((double)p_ulus / (double)p_ulcalls, 3);
+    Serial.println(" us/call");
+  #else
+    printf("%-12s %-18s %8lu calls %10.3f us/call\n", p_ccname, p_ccfixture, p_ulcalls, (double)p_ulus / (double)p_ulcalls);
+  #endif
+}
+
+void benchmark()
+{
+  int           i, k;
+  unsigned long ulStart;
+  double        dEL, dAZ, dLAT, dLON;
+
+  P13Observer   MyQTH(pcMyName, dMyLAT, dMyLON, dMyALT);
+  P13DateTime   MyTime;
+  P13Footprint  FP(adCircle, 90);
+  P13Sun        Sun;
+
+  for (k = 0; k < iFixtures; k++)
+  {
+    P13Satellite MySAT(tleFixtures[k][0], tleFixtures[k][1], tleFixtures[k][2]);
+
+    // TLE parsing and epoch constants
+    ulStart = micros();
+    for (i = 0; i < BENCH_N / 10; i++)
+      dSink += MySAT.tle(tleFixtures[k][0], tleFixtures[k][1], tleFixtures[k][2]);
+    report("tle", tleFixtures[k][0], BENCH_N / 10, micros() - ulStart);
+
+    // The same prediction with the SGP4 engine (near earth orbits only, the others
+    // stay with Plan13)
+    if (MySAT.engine(P13_ENG_SGP4) == P13_ENG_SGP4)
+    {
+      MyTime.settime(2021, 11, 18, 23, 8, 2);
+      ulStart = micros();
+      for (i = 0; i < BENCH_N; i++)
+      {
+        MySAT.predict(MyTime);
+        MyTime.add(dStep);
+      }
+      report("predict SGP4", tleFixtures[k][0], BENCH_N, micros() - ulStart);
+      MySAT.engine(P13_ENG_PLAN13);
+    }
+
+    // Prediction with time steps as in a tracking loop
+    MyTime.settime(2021, 11, 18, 23, 8, 2);
+    ulStart = micros();
+    for (i = 0; i < BENCH_N; i++)
+    {
+      MySAT.predict(MyTime);
+      MyTime.add(dStep);
+    }
+    report("predict", tleFixtures[k][0], BENCH_N, micros() - ulStart);
+
+    ulStart = micros();
+    for (i = 0; i < BENCH_N; i++)
+    {
+      MySAT.elaz(MyQTH, dEL, dAZ);
+      dSink += dEL;
+    }
+    report("elaz", tleFixtures[k][0], BENCH_N, micros() - ulStart);
+
+    ulStart = micros();
+    for (i = 0; i < BENCH_N; i++)
+      dSink += MySAT.doppler(437.8, P13_FTX);
+    report("doppler", tleFixtures[k][0], BENCH_N, micros() - ulStart);
+
+    MySAT.latlon(dLAT, dLON);
+    ulStart = micros();
+    for (i = 0; i < BENCH_N / 10; i++)
+    {
+      MySAT.footprint(aiFP, (sizeof(aiFP)/sizeof(int)/2), 320, 160, dLAT, dLON);
+      dSink += aiFP[0][0];
+    }
+    report("footprint90", tleFixtures[k][0], BENCH_N / 10, micros() - ulStart);
+
+    ulStart = micros();
+    for (i = 0; i < BENCH_N / 10; i++)
+    {
+      MySAT.footprint(FP, aiFP, 320, 160, auFPBreak);
+      dSink += aiFP[0][0];
+    }
+    report("footprint90c", tleFixtures[k][0], BENCH_N / 10, micros() - ulStart);
+
+    // Illumination of satellite and observer from a cached sun vector
+    Sun.refresh(MyTime);
+    ulStart = micros();
+    for (i = 0; i < BENCH_N; i++)
+      dSink += MySAT.illumination(Sun, MyQTH);
+    report("illumination", tleFixtures[k][0], BENCH_N, micros() - ulStart);
+  }
+
+  MyTime.settime(2021, 11, 18, 23, 8, 2);
+  ulStart = micros();
+  for (i = 0; i < BENCH_N; i++)
+  {
+    Sun.predict(MyTime);
+    MyTime.add(dStep);
+  }
+  report("predict", "Sun", BENCH_N, micros() - ulStart);
+
+  ulStart = micros();
+  for (i = 0; i < BENCH_N; i++)
+  {
+    Sun.elaz(MyQTH, dEL, dAZ);
+    dSink += dEL;
+  }
+  report("elaz", "Sun", BENCH_N, micros() - ulStart);
+
+  // Sun engine of Meeus with GMST instead of the Plan13 model
+  Sun.engine(P13_SUN_MEEUS);
+  MyTime.settime(2021, 11, 18, 23, 8, 2);
+  ulStart = micros();
+  for (i = 0; i < BENCH_N; i++)
+  {
+    Sun.predict(MyTime);
+    MyTime.add(dStep);
+  }
+  report("predict", "Sun Meeus", BENCH_N, micros() - ulStart);
+  Sun.engine(P13_SUN_PLAN13);
+
+  // Moon: single predictions and a table over a day at 1 minute steps
+  P13Moon Moon;
+
+  MyTime.settime(2021, 11, 18, 23, 8, 2);
+  ulStart = micros();
+  for (i = 0; i < BENCH_N / 10; i++)
+  {
+    Moon.predict(MyTime);
+    MyTime.add(dStep);
+  }
+  report("predict", "Moon", BENCH_N / 10, micros() - ulStart);
+
+  ulStart = micros();
+  for (i = 0; i < BENCH_N / 10; i++)
+  {
+    Moon.elaz(MyQTH, dEL, dAZ);
+    dSink += dEL;
+  }
+  report("elaz", "Moon", BENCH_N / 10, micros() - ulStart);
+
+  #ifndef __AVR__
+  ulStart = micros();
+  for (i = 0; i < BENCH_N / 1000 + 1; i++)
+  {
+    Moon.predictBatch(MyTime, 1.0 / 1440.0, 1440, NULL, NULL, adMoonEL, adMoonAZ, &MyQTH);
+    dSink += adMoonEL[0];
+  }
+  report("predictBatch", "Moon day", BENCH_N / 1000 + 1, micros() - ulStart);
+  #endif
+
+  // Time handling of a tracking tick: Unix time from NTP/GPS and ASCII output
+  ulStart = micros();
+  for (i = 0; i < BENCH_N; i++)
+  {
+    MyTime.setunix(1637276882UL + i);
+    dSink += MyTime.c_dTN;
+  }
+  report("setunix", "DateTime", BENCH_N, micros() - ulStart);
+
+  ulStart = micros();
+  for (i = 0; i < BENCH_N; i++)
+  {
+    MyTime.ascii(acTime);
+    dSink += acTime[18];
+  }
+  report("ascii", "DateTime", BENCH_N, micros() - ulStart);
+}
+
+void setup()
+{
+  #ifdef ARDUINO
+    Serial.begin(115200);
+    delay(10);
+    Serial.println();
+    Serial.println("AioP13 benchmark");
+  #else
+    printf("AioP13 benchmark\n");
+  #endif
+
+  benchmark();
+}
+
+void loop()
+{
+  // Nothing to do, the benchmark runs once in setup()
+}
+
+#ifndef ARDUINO
+int main()
+{
+  setup();
+  return 0;
+}
+#endif
@@ -0,0 +1,571 @@
+/* ====================================================================
+
+   Copyright (c) 2019-2021 Thorsten Godau (https://github.com/dl9sec)
+   All rights reserved.
+
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+
+   3. Neither the name of the author(s) nor the names of any contributors
+      may be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR(S) AND CONTRIBUTORS "AS IS" AND
+   ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+   IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+   ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR(S) OR CONTRIBUTORS BE LIABLE
+   FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+   DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+   OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+   HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+   LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+   OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+   SUCH DAMAGE.
+
+   ====================================================================*/
+
+
+
+// Regression of accuracy and speed: predictions of fixed satellites at fixed times
+// are compared to stored references for every fast path of the library, together
+// with the time per call. A change that makes a path faster but takes it out of its
+// tolerance fails here, while BenchmarkP13 would only show the gain.
+//
+// References:
+// - Golden values of predict() in double precision from this library (print new ones
+//   with REGRESSION_DUMP after an intended change of the model): sub-satellite point,
+//   elevation/azimuth and doppler offset at 437.8 MHz for DL9SEC every 3 hours for a day
+// - The ISS from Gpredict and the sun from sunearthtools.com, as in PredictISS
+// - The state vectors of SGP4 test case 00005 (Vallado et al., "Revisiting Spacetrack
+//   Report #3", 2006)
+//
+// Runs on the boards as a normal sketch (results to Serial) and on a PC without the
+// Arduino core (results to stdout, exit code 1 on failure):
+//
+//   g++ -O2 -x c++ -Isrc examples/RegressionP13/RegressionP13.ino -x none src/AioP13.cpp -o regression
+//
+// Add -DP13_FLOAT for the single precision paths (with their own tolerances) or
+// -DREGRESSION_DUMP to print the golden table instead of the regression.
+
+#include <AioP13.h>
+
+#ifndef ARDUINO
+  #include <chrono>
+
+  static unsigned long micros()
+  {
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+#endif
+
+#define REG_SAMPLES  8               // Samples per fixture
+#define REG_STEPS    360             // Steps between two samples (3 h)
+#define REG_NODES    12              // Nodes of the ephemeris
+
+#define REG_LAT      0               // Columns of the golden table
+#define REG_LON      1
+#define REG_EL       2
+#define REG_AZ       3
+#define REG_DOP      4
+#define REG_COLS     5
+
+#define REG_PREDICT   0              // Paths under test
+#define REG_PROPAGATE 1
+#define REG_TRACKER   2
+#define REG_EPHEMERIS 3
+#define REG_PATHS     4
+
+// Fixtures: low, medium and high earth orbit (high eccentricity) and geostationary
+const char *tleFixtures[][3] = {
+  { "ISS (ZARYA) LEO",  "1 25544U 98067A   21320.51955234  .00001288  00000+0  31985-4 0  9990",
+                        "2 25544  51.6447 309.4881 0004694 203.6966 299.8876 15.48582035312205" },
+  { "GPS BIIR-2 MEO",   "1 24876U 97035A   21320.43802679 -.00000034  00000+0  00000+0 0  9994",
+                        "2 24876  55.5703 183.4164 0049805  51.6689 308.7904  2.00563379177777" },
+  { "MOLNIYA 1-91 HEO", "1 25485U 98054A   21320.21053930  .00000081  00000-0  00000-0 0  9990",
+                        "2 25485  64.0883  11.9585 6941392 290.3884  11.8632  2.36434930169823" },
+  { "ES'HAIL 2 GEO",    "1 43700U 18090A   21320.51254296  .00000150  00000+0  00000+0 0  9998",
+                        "2 43700   0.0138 278.3980 0002418 337.0092  10.7288  1.00272495 10898" }
+};
+
+const int    iFixtures = sizeof(tleFixtures) / sizeof(tleFixtures[0]);
+
+const char  *pcMyName  = "DL9SEC";   // Observer name
+double       dMyLAT    =  48.661563; // Latitude (Breitengrad): N -> +, S -> -
+double       dMyLON    =   9.779416; // Longitude (Längengrad): E -> +, W -> -
+double       dMyALT    = 386.0;      // Altitude ASL (m)
+
+double       dStepSec  = 30.0;       // Time step between predictions (s)
+double       dFreq     = 437.8;      // Frequency for the doppler offset (MHz)
+
+const char  *apcPaths[REG_PATHS] = { "predict", "propagate", "tracker", "ephemeris" };
+
+// Golden values from predict() in double precision, REG_SAMPLES rows per fixture from
+// 2021-11-18 23:08:02 UTC every 3 hours: lat, lon, el, az (deg), doppler offset (Hz)
+const double adGolden[][REG_COLS] PROGMEM = {
+  // ISS (ZARYA) LEO
+  {   50.6372156,   -2.5359939,   20.4353409,  289.7437256,    9414.3217 },
+  {   49.8141954,  -84.0250742,  -24.9410099,  309.9796984,    8472.7312 },
+  {   39.5572772, -158.4821298,  -43.6414754,  351.0017578,    5207.7019 },
+  {   24.2986968,  135.8925781,  -44.4433127,   47.3503235,    2122.0494 },
+  {    7.0448359,   74.8304948,  -31.4201958,  104.3489904,    2073.3638 },
+  {  -10.6711929,   14.9020039,  -26.5303944,  174.1343526,    6885.4144 },
+  {  -27.6766723,  -46.7858190,  -43.9814807,  227.8034171,    7169.1123 },
+  {  -42.2308665, -113.9196280,  -69.7989561,  257.8731232,    3457.5033 },
+  // GPS BIIR-2 MEO
+  {   19.6063012,  152.2327764,  -26.4045441,   36.2402430,     834.6052 },
+  {   48.3594942, -137.4693340,   -2.8117772,  338.5307198,    -431.1694 },
+  {  -20.4318576, -117.3611699,  -48.5590264,  284.6317909,    -449.1195 },
+  {  -48.6232709,  -48.3761991,  -31.2686560,  216.5780296,     865.9136 },
+  {   20.4312511,  -27.6176291,   38.0001769,  240.0753567,     782.0950 },
+  {   47.8118892,   43.3217367,   61.1624723,   79.3267288,    -436.3138 },
+  {  -21.2399123,   62.7837907,   -8.0217198,  131.5428509,   -1004.4863 },
+  {  -48.0877860,  132.4171283,  -59.7504823,  111.3814450,    -155.8244 },
+  // MOLNIYA 1-91 HEO
+  {   55.0937795,  102.1664593,   28.8701094,   45.5892727,     314.6716 },
+  {   25.6946440,   87.6320001,   12.9777182,   80.6642344,    3192.7379 },
+  {   53.1645945,  -83.5583333,   20.3957272,  312.8795609,   -3290.2716 },
+  {   60.8070081,  -49.5409429,   49.0245596,  312.9349946,    -630.4217 },
+  {   41.1603100,  -59.4124705,   33.1980075,  288.4310226,    1848.4365 },
+  {  -16.7433661,   92.1725203,  -41.4415362,  106.6013545,    -980.2299 },
+  {   63.9683889,  151.3358681,   16.9451176,   17.7550962,   -1857.8660 },
+  {   50.6687238,  153.9266403,    4.5781268,   22.4787322,     787.2219 },
+  // ES'HAIL 2 GEO
+  {    0.0063279,   25.8518953,   32.0678047,  158.9912320,      -0.1336 },
+  {   -0.0042215,   25.8331327,   32.0610145,  159.0180696,       0.6267 },
+  {   -0.0122882,   25.8250300,   32.0532360,  159.0307306,       1.0194 },
+  {   -0.0131199,   25.8332175,   32.0488339,  159.0206830,       0.8130 },
+  {   -0.0062204,   25.8537428,   32.0501783,  158.9927487,       0.1285 },
+  {    0.0043456,   25.8753883,   32.0562448,  158.9622803,      -0.6308 },
+  {    0.0123491,   25.8862871,   32.0632293,  158.9461148,      -1.0172 },
+  {    0.0130784,   25.8809204,   32.0667931,  158.9526441,      -0.8035 }
+};
+
+// Tolerances (lat, lon, el, az in deg, doppler in Hz) of the paths against the golden
+// values. In double precision only the fast paths deviate from predict(); in single
+// precision all paths have the deviations of P13_FLOAT (see README), on AVR in
+// addition those of day numbers and elapsed times in 32 bit (estimated from the UNO
+// results of PredictISS).
+#if defined(__AVR__)
+const double adTol[REG_PATHS][REG_COLS] = {
+  { 0.1,  0.1,  1.0,  1.0,  50.0  },   // predict
+  { 0.1,  0.1,  1.0,  1.0,  50.0  },   // propagate
+  { 0.1,  0.1,  1.0,  1.0,  50.0  },   // tracker
+  { 0.1,  0.1,  1.0,  1.0,  50.0  }    // ephemeris
+};
+  #define TOL_MODEL    1.0           // Plan13 against Gpredict (deg)
+#elif defined(P13_FLOAT)
+const double adTol[REG_PATHS][REG_COLS] = {
+  { 2E-4, 2E-4, 2E-4, 2E-4, 0.01  },   // predict
+  { 2E-4, 2E-4, 2E-4, 2E-4, 0.01  },   // propagate
+  { 2E-4, 2E-4, 2E-4, 2E-4, 0.01  },   // tracker
+  { 2E-4, 2E-4, 2E-4, 2E-4, 0.5   }    // ephemeris, error bound 10 m
+};
+  #define TOL_MODEL    0.5
+#else
+const double adTol[REG_PATHS][REG_COLS] = {
+  { 1E-6, 1E-6, 1E-6, 1E-6, 0.001 },   // predict
+  { 1E-6, 1E-6, 1E-6, 1E-6, 0.001 },   // propagate
+  { 1E-5, 1E-5, 1E-5, 1E-5, 0.001 },   // tracker, angle addition
+  { 1E-4, 1E-4, 1E-4, 1E-4, 0.5   }    // ephemeris, error bound 10 m
+};
+  #define TOL_MODEL    0.5
+#endif
+
+#define TOL_SUN      0.05            // Plan13 sun against sunearthtools.com (deg)
+
+#if defined(P13_FLOAT)
+  #define TOL_SGP4_POS 1E-3          // SGP4 against Vallado (km, km/s)
+  #define TOL_SGP4_VEL 1E-6
+#else
+  #define TOL_SGP4_POS 1E-5
+  #define TOL_SGP4_VEL 1E-8
+#endif
+
+Vec3          avecS[REG_NODES];      // Nodes of the ephemeris
+Vec3          avecV[REG_NODES];      // -"-
+int           iFailed = 0;           // Number of failed checks
+
+volatile double dSink  = 0;          // Keeps the compiler from removing the calls
+
+// Difference a - b of two angles (deg), reduced to -180..180
+double angdiff(double p_da, double p_db)
+{
+  double d = fmod(p_da - p_db, 360.0);
+
+  if (d >  180.0) d -= 360.0;
+  if (d < -180.0) d += 360.0;
+
+  return (d);
+}
+
+// Prints one result line of a path: fixture, max. errors (marked with * if out of
+// tolerance) and time per prediction. Returns true if all errors are in tolerance.
+bool report(int p_ipath, const char *p_ccfixture, const double *p_aderr, unsigned long p_ulcalls, unsigned long p_ulus)
+{
+  int  i;
+  bool bPass = true;
+
+  for (i = 0; i < REG_COLS; i++)
+    if (!(p_aderr[i] <= adTol[p_ipath][i])) bPass = false;
+
+  if (!bPass) iFailed++;
+
+  #ifdef ARDUINO
+    Serial.print(apcPaths[p_ipath]);
+    Serial.print("\t");
+    Serial.print(p_ccfixture);
+    for (i = 0; i < REG_COLS; i++)
+    {
+      Serial.print("\t");
+      Serial.print(p_aderr[i], 7);
+      Serial.print((p_aderr[i] <= adTol[p_ipath][i]) ? " " : "*");
+    }
+    Serial.print("\t");
+    Serial.print((double)p_ulus / (double)p_ulcalls, 3);
+    Serial.print(" us/call\t");
+    Serial.println(bPass ? "PASS" : "FAIL");
+  #else
+    printf("%-10s %-18s", apcPaths[p_ipath], p_ccfixture);
+    for (i = 0; i < REG_COLS; i++)
+      printf(" %9.2e%c", p_aderr[i], (p_aderr[i] <= adTol[p_ipath][i]) ? ' ' : '*');
+    printf(" %8.3f us/call  %s\n", (double)p_ulus / (double)p_ulcalls, bPass ? "PASS" : "FAIL");
+  #endif
+
+  return (bPass);
+}
+
+// Prints the result of a check against an external reference: deviation, tolerance
+// and unit. Returns true if the deviation is in tolerance.
+bool check(const char *p_ccname, const char *p_ccwhat, double p_derr, double p_dtol, const char *p_ccunit)
+{
+  bool bPass = (fabs(p_derr) <= p_dtol);
+
+  if (!bPass) iFailed++;
+
+  #ifdef ARDUINO
+    Serial.print(p_ccname);
+    Serial.print("\t");
+    Serial.print(p_ccwhat);
+    Serial.print("\t");
+    Serial.print(fabs(p_derr), 7);
+    Serial.print(" / ");
+    Serial.print(p_dtol, 7);
+    Serial.print(" ");
+    Serial.print(p_ccunit);
+    Serial.print("\t");
+    Serial.println(bPass ? "PASS" : "FAIL");
+  #else
+    printf("%-10s %-28s %9.2e / %9.2e %-4s %s\n", p_ccname, p_ccwhat, fabs(p_derr), p_dtol, p_ccunit, bPass ? "PASS" : "FAIL");
+  #endif
+
+  return (bPass);
+}
+
+// Lat, lon, el, az and doppler offset of the satellite after its last prediction
+void values(P13Satellite &p_sat, const P13Observer &p_obs, double *p_adval)
+{
+  p_sat.latlon(p_adval[REG_LAT], p_adval[REG_LON]);
+  p_sat.elaz(p_obs, p_adval[REG_EL], p_adval[REG_AZ]);
+  p_adval[REG_DOP] = p_sat.dopplerOffset(dFreq) * 1E6;
+}
+
+// The same from a state of propagate(), without changing the satellite
+void values(const P13Satellite &p_sat, const P13State &p_st, const P13Observer &p_obs, double *p_adval)
+{
+  P13Look lk = p_sat.look(p_st, p_obs);
+
+  p_sat.latlon(p_st, p_adval[REG_LAT], p_adval[REG_LON]);
+  p_adval[REG_EL]  = lk.c_dEL;
+  p_adval[REG_AZ]  = lk.c_dAZ;
+  p_adval[REG_DOP] = -dFreq * lk.c_dRR / 299792.0 * 1E6;
+}
+
+// Keeps the max. deviations of the values from row r of the golden table
+void compare(const double *p_adval, int p_ir, double *p_aderr)
+{
+  int    i;
+  double adRow[REG_COLS], d;
+
+  memcpy_P(adRow, adGolden[p_ir], sizeof(adRow));
+
+  for (i = 0; i < REG_COLS; i++)
+  {
+    d = ((i == REG_LON) || (i == REG_AZ)) ? angdiff(p_adval[i], adRow[i]) : p_adval[i] - adRow[i];
+    p_aderr[i] = max(p_aderr[i], fabs(d));
+  }
+}
+
+// Runs one path for one fixture: REG_STEPS predictions between the samples (timed)
+// and the comparison at the samples (not timed)
+void run(int p_ipath, int p_ik, const P13Observer &p_obs, double *p_aderr, unsigned long &p_ulcalls, unsigned long &p_ulus)
+{
+  int           i, j;
+  unsigned long ulStart;
+  double        adVal[REG_COLS];
+
+  P13Satellite  MySAT(tleFixtures[p_ik][0], tleFixtures[p_ik][1], tleFixtures[p_ik][2]);
+  P13DateTime   MyTime(2021, 11, 18, 23, 8, 2);
+  P13Tracker    MyTracker(MySAT, dStepSec);
+  P13Ephemeris  MyEph(MySAT, avecS, avecV, REG_NODES);
+  P13State      MyState;
+
+  for (i = 0; i < REG_COLS; i++)
+    p_aderr[i] = 0.0;
+
+  p_ulcalls = 0;
+  p_ulus    = 0;
+
+  for (j = 0; j < REG_SAMPLES; j++)
+  {
+    ulStart = micros();
+    for (i = 0; i < ((j == 0) ? 1 : REG_STEPS); i++)
+    {
+      if (j > 0) MyTime.add(dStepSec / 86400.0);
+
+      switch (p_ipath)
+      {
+        case REG_PREDICT:
+          MySAT.predict(MyTime);
+          break;
+        case REG_PROPAGATE:
+          MyState = MySAT.propagate(MyTime);
+          dSink += MyState.c_dRS;
+          break;
+        case REG_TRACKER:
+          if (j == 0) MyTracker.start(MyTime); else MyTracker.step();
+          break;
+        case REG_EPHEMERIS:
+          MyEph.predict(MyTime);
+          break;
+      }
+    }
+    p_ulus    += micros() - ulStart;
+    p_ulcalls += i;
+
+    if (p_ipath == REG_PROPAGATE)
+      values(MySAT, MyState, p_obs, adVal);
+    else
+      values(MySAT, p_obs, adVal);
+
+    #ifdef REGRESSION_DUMP
+      if (j == 0) printf("  // %s\n", tleFixtures[p_ik][0]);
+      printf("  { %12.7f, %12.7f, %12.7f, %12.7f, %12.4f },\n", adVal[0], adVal[1], adVal[2], adVal[3], adVal[4]);
+    #else
+      compare(adVal, p_ik * REG_SAMPLES + j, p_aderr);
+    #endif
+  }
+}
+
+// Checks against external references. Plan13 is a simpler model than SGP4 of
+// Gpredict, so the tolerance is the accuracy of the model 5 days after the epoch.
+void external(const P13Observer &p_obs)
+{
+  double        dEL, dAZ;
+
+  P13DateTime   MyTime(2021, 11, 18, 23, 8, 2);
+  P13Satellite  MySAT(tleFixtures[0][0], tleFixtures[0][1], tleFixtures[0][2]);
+  P13Sun        Sun;
+
+  MySAT.predict(MyTime);
+  MySAT.elaz(p_obs, dEL, dAZ);
+  check("gpredict", "ISS elevation", dEL - 20.12, TOL_MODEL, "deg");
+  check("gpredict", "ISS azimuth", angdiff(dAZ, 289.61), TOL_MODEL, "deg");
+
+  Sun.predict(MyTime);
+  Sun.elaz(p_obs, dEL, dAZ);
+  check("sunearth", "Sun elevation", dEL + 60.79, TOL_SUN, "deg");
+  check("sunearth", "Sun azimuth", angdiff(dAZ, 0.86), TOL_SUN, "deg");
+
+  #ifdef P13_SGP4
+  // SGP4 test case 00005 (e = 0.19) at 0, 360 and 720 min from the epoch: TEME
+  // position (km) and velocity (km/s)
+  const double adVallado[3][7] = {
+    {   0.0,  7022.46529266, -1400.08296755,     0.03995155,  1.893841015,  6.405893759,  4.534807250 },
+    { 360.0, -7154.03120202, -3783.17682504, -3536.19412294,  4.741887409, -4.151817765, -2.093935425 },
+    { 720.0, -7134.59340119,  6531.68641334,  3260.27186483, -4.113793027, -2.911922039, -2.557327851 }
+  };
+
+  int           i, j;
+  unsigned long ulStart, ulUs = 0;
+  double        dD, dDS, dDV, dMaxDS = 0.0, dMaxDV = 0.0;
+
+  P13Satellite  Sat5("00005", "1 00005U 58002B   00179.78495062  .00000023  00000-0  28098-4 0  4753",
+                              "2 00005  34.2682 348.7242 1859667 331.7664  19.3264 10.82419157413667");
+
+  Sat5.engine(P13_ENG_SGP4);
+
+  for (i = 0; i < 3; i++)
+  {
+    MyTime.c_lDN = 730135L - 1 + 179;   // Day number of the epoch 2000, day 179
+    MyTime.c_dTN = 0.78495062;
+    MyTime.add(adVallado[i][0] / 1440.0);
+
+    ulStart = micros();
+    Sat5.predict(MyTime);
+    ulUs += micros() - ulStart;
+
+    dDS = 0.0;
+    dDV = 0.0;
+    for (j = 0; j < 3; j++)
+    {
+      dD   = Sat5.c_vecSAT[j] - adVallado[i][1 + j];
+      dDS += dD * dD;
+      dD   = Sat5.c_vecVEL[j] - adVallado[i][4 + j];
+      dDV += dD * dD;
+    }
+    dMaxDS = max(dMaxDS, sqrt(dDS));
+    dMaxDV = max(dMaxDV, sqrt(dDV));
+  }
+
+  check("vallado", "00005 SGP4 position", dMaxDS, TOL_SGP4_POS, "km");
+  check("vallado", "00005 SGP4 velocity", dMaxDV, TOL_SGP4_VEL, "km/s");
+  #endif
+}
+
+// Consistency of the pass search: the passes of the ISS over 3 days for an observer
+// with grazing passes (35N 139E, minel 0), searched on from LOS each time. Every pass needs AOS <= TCA <= LOS,
+// TCA at least at minel and LOS after the start of the search.
+void passes()
+{
+  int           i, iBad = 0;
+  double        dFrom, dAOS, dTCA, dLOS;
+  unsigned long ulStart, ulUs;
+
+  P13Observer   Tokyo("Tokyo", 35.0, 139.0, 0.0);
+  P13Satellite  MySAT(tleFixtures[0][0], tleFixtures[0][1], tleFixtures[0][2]);
+  P13DateTime   MyStart(2021, 11, 17, 0, 0, 0);
+  P13DateTime   MyFrom(MyStart);
+  P13Pass       MyPass;
+
+  ulStart = micros();
+  for (i = 0; (i < 60) && MySAT.nextPass(Tokyo, MyFrom, MyPass, 0.0, 1.0); i++)
+  {
+    dFrom = (double)(MyFrom.c_lDN - MyStart.c_lDN) + (MyFrom.c_dTN - MyStart.c_dTN);
+    dAOS  = (double)(MyPass.c_dtAOS.c_lDN - MyStart.c_lDN) + (MyPass.c_dtAOS.c_dTN - MyStart.c_dTN);
+    dTCA  = (double)(MyPass.c_dtTCA.c_lDN - MyStart.c_lDN) + (MyPass.c_dtTCA.c_dTN - MyStart.c_dTN);
+    dLOS  = (double)(MyPass.c_dtLOS.c_lDN - MyStart.c_lDN) + (MyPass.c_dtLOS.c_dTN - MyStart.c_dTN);
+
+    if ((dAOS > dTCA) || (dTCA > dLOS) || (dLOS < dFrom) || (MyPass.c_dMaxEL < 0.0))
+      iBad++;
+
+    if (dLOS > 3.0)
+      break;
+
+    MyFrom = MyPass.c_dtLOS;
+    MyFrom.add(1.0 / 86400.0);
+  }
+  ulUs = micros() - ulStart;
+
+  check("nextPass", "ISS grazing, bad passes", iBad, 0.0, "");
+  check("nextPass", "ISS grazing, no passes", (i == 0) ? 1.0 : 0.0, 0.0, "");
+
+  #ifdef ARDUINO
+    Serial.print("nextPass\t");
+    Serial.print((double)ulUs / (double)max(i, 1), 3);
+    Serial.println(" us/call");
+  #else
+    printf("nextPass   %-28s %9.3f us/call\n", "ISS grazing", (double)ulUs / (double)max(i, 1));
+  #endif
+}
+
+// P13Catalog::predict() uses the same code as P13Satellite::predict(), so the state
+// vectors of the catalog have to be bit-identical to those of the single satellites.
+void catalog()
+{
+  int           j, k, iDiff = 0;
+
+  P13Catalog    MyCat(iFixtures);
+
+  for (k = 0; k < iFixtures; k++)
+    MyCat.add(tleFixtures[k][0], tleFixtures[k][1], tleFixtures[k][2]);
+
+  for (k = 0; k < iFixtures; k++)
+  {
+    P13Satellite MySAT(tleFixtures[k][0], tleFixtures[k][1], tleFixtures[k][2]);
+    P13DateTime  MyTime(2021, 11, 18, 23, 8, 2);
+
+    for (j = 0; j < REG_SAMPLES; j++)
+    {
+      MySAT.predict(MyTime);
+      MyCat.predict(MyTime);
+
+      if ((MyCat.c_adSX[k] != MySAT.c_vecS[0]) || (MyCat.c_adSY[k] != MySAT.c_vecS[1]) || (MyCat.c_adSZ[k] != MySAT.c_vecS[2]) ||
+          (MyCat.c_adVX[k] != MySAT.c_vecV[0]) || (MyCat.c_adVY[k] != MySAT.c_vecV[1]) || (MyCat.c_adVZ[k] != MySAT.c_vecV[2]))
+        iDiff++;
+
+      MyTime.add(REG_STEPS * dStepSec / 86400.0);
+    }
+  }
+
+  check("catalog", "states not bit-identical", iDiff, 0.0, "");
+}
+
+void regression()
+{
+  int           k;
+  unsigned long ulCalls, ulUs;
+  double        adErr[REG_COLS];
+
+  P13Observer   MyQTH(pcMyName, dMyLAT, dMyLON, dMyALT);
+
+  #ifdef REGRESSION_DUMP
+    for (k = 0; k < iFixtures; k++)
+      run(REG_PREDICT, k, MyQTH, adErr, ulCalls, ulUs);
+  #else
+    int p;
+
+    for (p = 0; p < REG_PATHS; p++)
+      for (k = 0; k < iFixtures; k++)
+      {
+        run(p, k, MyQTH, adErr, ulCalls, ulUs);
+        report(p, tleFixtures[k][0], adErr, ulCalls, ulUs);
+      }
+
+    external(MyQTH);
+    passes();
+    catalog();
+  #endif
+}
+
+void setup()
+{
+  #ifdef ARDUINO
+    Serial.begin(115200);
+    delay(10);
+    Serial.println();
+    Serial.println("AioP13 regression (max. error lat, lon, el, az in deg, doppler in Hz)");
+  #else
+    printf("AioP13 regression (max. error lat, lon, el, az in deg, doppler in Hz)\n");
+  #endif
+
+  regression();
+
+  #ifdef ARDUINO
+    Serial.println(iFailed ? "FAIL" : "PASS");
+  #else
+    printf("%s (%d failed)\n", iFailed ? "FAIL" : "PASS", iFailed);
+  #endif
+}
+
+void loop()
+{
+  // Nothing to do, the regression runs once in setup()
+}
+
+#ifndef ARDUINO
+int main()
+{
+  setup();
+  return (iFailed ? 1 : 0);
+}
+#endif
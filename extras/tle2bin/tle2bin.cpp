@@ -0,0 +1,160 @@
+//
+// tle2bin.cpp
+//
+// Converts a TLE file (2 or 3 lines per satellite) to binary element records of
+// AioP13 (see P13_REC_SIZE in AioP13.h), which P13Satellite::load() and
+// P13Catalog::loadRecords() use without parsing the TLEs.
+//
+// Build on the host with
+//
+//   g++ -O2 -I../../src tle2bin.cpp ../../src/AioP13.cpp -o tle2bin
+//
+// Usage
+//
+//   tle2bin input.txt output.bin          Binary file, e.g. for SD card, SPIFFS or an OTA update
+//   tle2bin -c name input.txt output.h    C array "name" in PROGMEM with name_count records
+//
+// TLEs with a wrong format or checksum are skipped and reported on stderr.
+//
+
+#include <stdio.h>
+#include <string.h>
+
+#include "AioP13.h"
+
+#define LINE_MAX_LEN 256
+
+
+// Strips line end and trailing blanks
+static void strip(char *p_acline) {
+    
+    size_t l_uilen = strlen(p_acline);
+    
+    while ( (l_uilen > 0) && ((p_acline[l_uilen - 1] == '\n') || (p_acline[l_uilen - 1] == '\r') || (p_acline[l_uilen - 1] == ' ')) )
+        p_acline[--l_uilen] = '\0';
+}
+
+
+// Writes one record as binary or as lines of the C array
+static void writerecord(FILE *p_fout, const uint8_t *p_aurec, bool p_bc) {
+    
+    int l_ii;
+    
+    if ( !p_bc )
+    {
+        fwrite(p_aurec, 1, P13_REC_SIZE, p_fout);
+        return;
+    }
+    
+    for ( l_ii = 0; l_ii < P13_REC_SIZE; l_ii++ )
+        fprintf(p_fout, "%s0x%02X,%s", (l_ii % 20) ? "" : "    ", p_aurec[l_ii], ((l_ii % 20) == 19) ? "\n" : " ");
+}
+
+
+int main(int argc, char *argv[]) {
+    
+    FILE        *l_fin, *l_fout;
+    const char  *l_ccarray = NULL;
+    char         l_acname[LINE_MAX_LEN] = "";
+    char         l_acl1[LINE_MAX_LEN]   = "";
+    char         l_acline[LINE_MAX_LEN];
+    uint8_t      l_aurec[P13_REC_SIZE];
+    int          l_iarg = 1;
+    int          l_istat;
+    long         l_lline = 0;
+    unsigned     l_ucount = 0, l_uerrors = 0;
+    P13Satellite l_sat("", "", "");     // Empty satellite, tle() for every TLE
+    
+    if ( (argc == 5) && !strcmp(argv[1], "-c") )
+    {
+        l_ccarray = argv[2];
+        l_iarg    = 3;
+    }
+    else if ( argc != 3 )
+    {
+        fprintf(stderr, "Usage: %s [-c name] input.txt output\n", argv[0]);
+        return (2);
+    }
+    
+    l_fin = fopen(argv[l_iarg], "r");
+    
+    if ( !l_fin )
+    {
+        fprintf(stderr, "Cannot open %s\n", argv[l_iarg]);
+        return (1);
+    }
+    
+    l_fout = fopen(argv[l_iarg + 1], l_ccarray ? "w" : "wb");
+    
+    if ( !l_fout )
+    {
+        fprintf(stderr, "Cannot create %s\n", argv[l_iarg + 1]);
+        fclose(l_fin);
+        return (1);
+    }
+    
+    if ( l_ccarray )
+        fprintf(l_fout, "// Binary element records of AioP13, generated by tle2bin from %s\n\nconst uint8_t %s[] PROGMEM = {\n", argv[l_iarg], l_ccarray);
+    
+    while ( fgets(l_acline, sizeof(l_acline), l_fin) )
+    {
+        l_lline++;
+        strip(l_acline);
+        
+        if ( l_acline[0] == '\0' )
+            continue;
+        
+        // Same rules as P13Catalog::loadline()
+        if ( (strlen(l_acline) >= 68) && (l_acline[0] == '1') && (l_acline[1] == ' ') )
+        {
+            strcpy(l_acl1, l_acline);
+        }
+        else if ( (strlen(l_acline) >= 68) && (l_acline[0] == '2') && (l_acline[1] == ' ') && l_acl1[0] )
+        {
+            l_istat = l_sat.tle(l_acname, l_acl1, l_acline);
+            
+            if ( l_istat == P13_TLE_OK )
+            {
+                l_sat.save(l_aurec);
+                writerecord(l_fout, l_aurec, l_ccarray != NULL);
+                l_ucount++;
+            }
+            else
+            {
+                fprintf(stderr, "Line %ld: %s of \"%s\", skipped\n", l_lline, (l_istat == P13_TLE_ECHECKSUM) ? "wrong checksum" : "wrong format", l_acname);
+                l_uerrors++;
+            }
+            
+            l_acname[0] = l_acl1[0] = '\0';
+        }
+        else if ( (strlen(l_acline) >= 68) && (l_acline[0] == '2') && (l_acline[1] == ' ') )
+        {
+            fprintf(stderr, "Line %ld: line 2 without line 1, skipped\n", l_lline);
+            l_uerrors++;
+            
+            l_acname[0] = '\0';
+        }
+        else
+        {
+            if ( l_acl1[0] )
+            {
+                fprintf(stderr, "Line %ld: no line 2 after line 1, skipped\n", l_lline);
+                l_uerrors++;
+            }
+            
+            // Name line (TLE line 0), with or without "0 " prefix
+            strcpy(l_acname, ((strlen(l_acline) > 2) && (l_acline[0] == '0') && (l_acline[1] == ' ')) ? &l_acline[2] : l_acline);
+            l_acl1[0] = '\0';
+        }
+    }
+    
+    if ( l_ccarray )
+        fprintf(l_fout, "};\n\nconst uint16_t %s_count = %u;\n", l_ccarray, l_ucount);
+    
+    fclose(l_fin);
+    fclose(l_fout);
+    
+    fprintf(stderr, "%u records written, %u TLEs skipped\n", l_ucount, l_uerrors);
+    
+    return (l_uerrors ? 1 : 0);
+}
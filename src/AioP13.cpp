@@ -1,775 +1,5687 @@
-//
-// AioP13.cpp
-//
-// An implementation of Plan13 in C++ by Mark VandeWettering
-//
-// Plan13 is an algorithm for satellite orbit prediction first formulated
-// by James Miller G3RUH.  I learned about it when I saw it was the basis 
-// of the PIC based antenna rotator project designed by G6LVB.
-//
-// http://www.g6lvb.com/Articles/LVBTracker2/index.htm
-//
-// I ported the algorithm to Python, and it was my primary means of orbit
-// prediction for a couple of years while I operated the "Easy Sats" with 
-// a dual band hand held and an Arrow antenna.
-//
-// I've long wanted to redo the work in C++ so that I could port the code
-// to smaller processors including the Atmel AVR chips.  Bruce Robertson,
-// VE9QRP started the qrpTracker project to fulfill many of the same goals,
-// but I thought that the code could be made more compact and more modular,
-// and could serve not just the embedded targets but could be of more
-// use for more general applications.  And, I like the BSD License a bit
-// better too.
-//
-// So, here it is!
-//
-// =====================================================================
-//
-// dl9sec@gmx.net (02..11/2021):
-//
-// The original Plan13 BBC Basic source code can be found at:
-//
-// https://www.amsat.org/articles/g3ruh/111.html
-//
-// Published as "Donationware" in favour of AMSAT-UK, LONDON, E12 5EQ
-// and the AO-13 Amateur Satellite Program.
-//
-// Changes:
-// - Refactoring for seamless use with Arduino.
-// - Renamed class DateTime to P13DateTime because of potential conflict
-//   with RTClib, which uses the same class name.
-// - Renamed all classes to P13... for consistency and clarification of
-//   affiliation.
-// - Some code beautification.
-// - Changed output of method "ascii" to ISO date format
-// - Added helper function for converting lat/lon coordinates to rectangular
-//   map coordinates
-// - Used all double
-// - Used PI instead of M_PI
-// - Used degrees() and radians() instead of DEGREES() and RADIANS()
-// - Inserted explicit casts
-// - Added a method "footprint" to class P13Satellite
-// - Added a method "doppler" to calculate down- and uplink frequencies
-// - Added a method "footprint" to class P13Sun
-// - Added implementation suggestion for P13Sun:elaz() by Uwe Nagel
-// - Renamed the whole stuff from ArduinoP13 to AioP13 to follow the
-//   Arduino library specifications for naming of libraries.
-// - Rework of all the variable names because of conflicts.
-//   All variables got a qualifier to get more or less unique names:
-//   "g_": global variables
-//   "c_": class public variables
-//   "cp_": class private variables
-//   "p_": parameter variable
-//   "l_": local variable
-//   The next letter gives a hint about the data type (e.g. "d": double,
-//   "i": integer, "cc": constant character, "vec": Vec3 vector, ...).
-//   In some cases this is very ugly, so all the variables should be renamed
-//   to speaking and useful names in one of the next releases.
-//
-// Uwe Nagel (09/2021)
-//
-// - Implementation of P13Sun:elaz()
-//
-// Mark Smith @SmittyHalibut (12/2021)
-//
-// - Added some helper constants, cleaned up compiler warnings.
-// - Copy Observer and Satellite name strings instead of assuming 
-//   the source is always there.
-// - Added `dopplerOffset()`
-//
-//----------------------------------------------------------------------
-
-#include "AioP13.h"
-
-
-//----------------------------------------------------------------------
-//  _  _     _                  __              _   _             
-// | || |___| |_ __  ___ _ _   / _|_  _ _ _  __| |_(_)___ _ _  ___
-// | __ / -_) | '_ \/ -_) '_| |  _| || | ' \/ _|  _| / _ \ ' \(_-<
-// |_||_\___|_| .__/\___|_|   |_|  \_,_|_||_\__|\__|_\___/_||_/__/
-//            |_|                                                 
-//
-//----------------------------------------------------------------------
-
-// Convert date to day-number
-static long fnday(int p_iy, int p_im, int p_id) {
-    
-    if ( p_im < 3 )
-    {
-        p_im += 12;
-        p_iy--;
-    }
-    
-    return ((long)((double)p_iy * g_scdYM) + (long)((double)(p_im + 1) * 30.6) + (long)(p_id - 428));
-}
-
-
-// Convert day-number to date; valid 1900 Mar 01 - 2100 Feb 28
-static void fndate(int &p_iy, int &p_im, int &p_id, long p_idt) {
-    
-    p_idt += 428L;
-    p_iy   = (int)(((double)p_idt - 122.1) / g_scdYM);
-    p_idt -= (long)((double)p_iy * g_scdYM);
-    p_im   = (int)((double)p_idt / 30.61);
-    p_idt -= (long)((double)p_im * 30.6);
-    p_im--;
-    
-    if ( p_im > 12 )
-    {
-        p_im -= 12;
-        p_iy++;
-    }
-    
-    p_id = (int)p_idt;
-}
-
-
-// Cut characters from c with start i0 to i1-1, append string
-// delimiter and convert to double
-static double getdouble(const char *p_ccc, int p_ii0, int p_ii1) {
-    
-    char l_acbuf[20];
-    int  l_ii;
-    
-    for ( l_ii = 0; (p_ii0 + l_ii) < p_ii1; l_ii++ ) {
-        l_acbuf[l_ii] = p_ccc[p_ii0 + l_ii];
-    }
-    
-    l_acbuf[l_ii] = '\0';
-    
-    return (strtod(l_acbuf, NULL));
-}
-
-
-// Cut characters from c with start i0 to i1-1, append string
-// delimiter and convert to long
-static long getlong(const char *p_ccc, int p_ii0, int p_ii1) {
-    
-    char l_acbuf[20];
-    int  l_ii;
-    
-    for ( l_ii = 0; (p_ii0 + l_ii) < p_ii1; l_ii++ ) {
-        l_acbuf[l_ii] = p_ccc[p_ii0 + l_ii];
-    }
-    
-    l_acbuf[l_ii] = '\0';
-    
-    return (atol(l_acbuf));
-}
-
-
-// Converts latitude (Breitengrad) -90..90° / longitude (Laengengrad) -180..180°
-// to x/y-coordinates of a map with maxamimum dimension MapMaxX * MapMaxY
-void latlon2xy(int &p_ix, int &p_iy, double p_dlat, double p_dlon, const int p_ciMapMaxX, const int p_ciMapMaxY) {
-    
-    p_ix = (int)((((180.0 + p_dlon) / 360.0) * (double)p_ciMapMaxX));
-    p_iy = (int)(((( 90.0 - p_dlat) / 180.0) * (double)p_ciMapMaxY));
-    
-}
-
-
-//----------------------------------------------------------------------
-//     _              ___  _ _______       _      _____ _           
-//  __| |__ _ ______ | _ \/ |__ /   \ __ _| |_ __|_   _(_)_ __  ___ 
-// / _| / _` (_-<_-< |  _/| ||_ \ |) / _` |  _/ -_)| | | | '  \/ -_)
-// \__|_\__,_/__/__/ |_|  |_|___/___/\__,_|\__\___||_| |_|_|_|_\___|
-//                                                       
-//----------------------------------------------------------------------
-
-P13DateTime::P13DateTime() {
-    
-   c_lDN = 0L;
-   c_dTN = 0.0;
-}
-
-
-P13DateTime::P13DateTime(const P13DateTime &p_dt) {
-    
-    c_lDN = p_dt.c_lDN;
-    c_dTN = p_dt.c_dTN;
-}
-
-
-P13DateTime::P13DateTime(int p_iyear, int p_imonth, int p_iday, int p_ih, int p_im, int p_is) {
-
-    settime(p_iyear, p_imonth, p_iday, p_ih, p_im, p_is);
-}
-
-
-P13DateTime::~P13DateTime() {
-    
-}
-
-
-void P13DateTime::add(double p_ddays) {
-    
-    c_dTN += p_ddays;
-    c_lDN += (long)c_dTN;
-    c_dTN -= (long)c_dTN;
-}
-
-
-void P13DateTime::settime(int p_iyear, int p_imonth, int p_iday, int p_ih, int p_im, int p_is) {
-    
-    c_lDN = fnday(p_iyear, p_imonth, p_iday);
-    c_dTN = ((double)p_ih + (double)p_im / 60.0 + (double)p_is / 3600.0) / 24.0;
-}
-
-
-void P13DateTime::gettime(int &p_iyear, int &p_imonth, int &p_iday, int &p_ih, int &p_im, int &p_is) {
-    
-    double l_dtime;
-
-    fndate(p_iyear, p_imonth, p_iday, c_lDN);
-    l_dtime  = c_dTN;
-    l_dtime *= 24.0;
-    p_ih  = (int)l_dtime;
-    l_dtime -= (double)p_ih;
-    l_dtime *= 60.0;
-    p_im  = (int)l_dtime;
-    l_dtime -= (double)p_im ;
-    l_dtime *= 60.0;
-    p_is  = (int)(l_dtime);
-}
-
-
-void P13DateTime::ascii(char *p_cbuf) {
-    
-    int l_iyear, l_imon, l_iday;
-    int l_ih, l_im, l_is;
-    
-    gettime(l_iyear, l_imon, l_iday, l_ih, l_im, l_is);
-    // 2019-05-11 00:53:13
-    sprintf(p_cbuf, "%4d-%02d-%02d %02d:%02d:%02d", l_iyear, l_imon, l_iday, l_ih, l_im, l_is);
-}
-
-
-void P13DateTime::roundup(double p_dtime) {
-    
-    double l_dinc;
-    
-    l_dinc = p_dtime - fmod(c_dTN, p_dtime);
-    
-    c_dTN += l_dinc;
-    c_lDN += (long)c_dTN;
-    c_dTN -= (long)c_dTN;
-}
-
-
-//----------------------------------------------------------------------
-//     _              ___  _ ____ ___  _                            
-//  __| |__ _ ______ | _ \/ |__ // _ \| |__ ___ ___ _ ___ _____ _ _ 
-// / _| / _` (_-<_-< |  _/| ||_ \ (_) | '_ (_-</ -_) '_\ V / -_) '_|
-// \__|_\__,_/__/__/ |_|  |_|___/\___/|_.__/__/\___|_|  \_/\___|_|  
-//                                                      
-//----------------------------------------------------------------------
-
-// Set the observers parameters from latitude, longitude and altitude
-// above sea level (m).
-P13Observer::P13Observer(const char *p_ccnm, double p_dlat, double p_dlon, double p_dasl) {
-    
-    double l_dD, l_dCL, l_dSL, l_dCO, l_dSO;
-    double l_dRx;
-    double l_dRz;
-    
-    uint8_t len = strlen(p_ccnm)%256;
-    c_ccObsName = new char[len+1];
-    strncpy(c_ccObsName, p_ccnm, len);
-    c_ccObsName[len] = '\0';
-
-    c_dLA = radians(p_dlat);
-    c_dLO = radians(p_dlon);
-    c_dHT = p_dasl / 1000.0;
-
-    l_dCL = cos(c_dLA);
-    l_dSL = sin(c_dLA);
-    l_dCO = cos(c_dLO);
-    l_dSO = sin(c_dLO);
-
-    c_vecU[0] = l_dCL * l_dCO;
-    c_vecU[1] = l_dCL * l_dSO;
-    c_vecU[2] = l_dSL;
-
-    c_vecE[0] = -l_dSO;
-    c_vecE[1] =  l_dCO;
-    c_vecE[2] =  0.0;
-
-    c_vecN[0] = -l_dSL * l_dCO;
-    c_vecN[1] = -l_dSL * l_dSO;
-    c_vecN[2] =  l_dCL;
-
-    l_dD = sqrt(g_scdRE * g_scdRE * l_dCL * l_dCL + g_scdRP * g_scdRP * l_dSL * l_dSL);
-    l_dRx = (g_scdRE * g_scdRE) / l_dD + c_dHT;
-    l_dRz = (g_scdRP * g_scdRP) / l_dD + c_dHT;
-
-    c_vecO[0] = l_dRx * c_vecU[0];
-    c_vecO[1] = l_dRx * c_vecU[1];
-    c_vecO[2] = l_dRz * c_vecU[2];
-
-    c_vecV[0] = -c_vecO[1] * g_scdW0;
-    c_vecV[1] =  c_vecO[0] * g_scdW0;
-    c_vecV[2] =  0.0;
-
-}
-
-
-P13Observer::~P13Observer() {
-    if (c_ccObsName) {
-        delete c_ccObsName;
-    }    
-}
-
-//----------------------------------------------------------------------
-//     _              ___  _ _______       _       _ _ _ _       
-//  __| |__ _ ______ | _ \/ |__ / __| __ _| |_ ___| | (_) |_ ___ 
-// / _| / _` (_-<_-< |  _/| ||_ \__ \/ _` |  _/ -_) | | |  _/ -_)
-// \__|_\__,_/__/__/ |_|  |_|___/___/\__,_|\__\___|_|_|_|\__\___|
-//
-//----------------------------------------------------------------------
-
-P13Satellite::P13Satellite(const char *p_ccnm, const char *p_ccl1, const char *p_ccl2) {
-    c_ccSatName = nullptr;
-    tle(p_ccnm, p_ccl1, p_ccl2);
-}
-
-P13Satellite::~P13Satellite() {
-    if (c_ccSatName) {
-        delete c_ccSatName;
-    }
-}
-
-// Get satellite data from the TLE
-
-void P13Satellite::tle(const char *p_ccnm, const char *p_ccl1, const char *p_ccl2) {
-    
-    double l_dCI;
-    
-    uint8_t len = strlen(p_ccnm)%256;
-    if (c_ccSatName) {
-        delete c_ccSatName;
-    }
-    c_ccSatName = new char[len+1];
-    strncpy(c_ccSatName, p_ccnm, len);
-    c_ccSatName[len] = '\0';
-
-
-    // Direct quantities from the orbital elements
-
-    cp_lN  = getlong(p_ccl1,  2,  7);               // Get satellite catalog number from tle:l1:2..6
-    cp_lYE = getlong(p_ccl1, 18, 20);               // Get epoch year from tle:l1:18..19
-        
-    if ( cp_lYE < 58 )
-        cp_lYE += 2000;
-    else
-        cp_lYE += 1900;
-
-    cp_dTE = getdouble(p_ccl1, 20, 32);             // Get epoch (day of the year and fractional portion of the day) from tle:l1:20..31
-    cp_dM2 = 2.0 * PI * getdouble(p_ccl1, 33, 43);  // Get first time derivative of the mean motion divided by to from tle:l1:33..42
-
-    cp_dIN = radians(getdouble(p_ccl2, 8, 16));     // Get inclination (degrees) from tle:l2:8..15
-    cp_dRA = radians(getdouble(p_ccl2, 17, 25));    // Get R.A.A.N (degrees) from tle:l2:17..24
-    cp_dEC = getdouble(p_ccl2, 26, 33) / 1.0E7;     // Get eccentricity from tle:l2:26..32
-    cp_dWP = radians(getdouble(p_ccl2, 34, 42));    // Get argument of perigee (degrees) from tle:l2:34..41
-    cp_dMA = radians(getdouble(p_ccl2, 43, 51));    // Get mean anomaly (degrees) from tle:l2:43..50
-    cp_dMM = 2.0 * PI * getdouble(p_ccl2, 52, 63);  // Get mean motion from tle:l2:52..62
-    cp_dRV = getlong(p_ccl2, 63, 68);               // Get Revolution number at epoch (revolutions) from tle:l2:63..67
-
-    // Derived quantities from the orbital elements 
-
-    // convert TE to DE and TE 
-    cp_lDE = fnday(cp_lYE, 1, 0) + (long)cp_dTE;
-    
-    cp_dTE -= (long)cp_dTE;
-
-    cp_dN0  = cp_dMM / 86400.0;
-    cp_dA_0 = pow(g_scdGM / (cp_dN0 * cp_dN0), 1.0/3.0);
-    cp_dB_0 = cp_dA_0 * sqrt(1.0 - cp_dEC * cp_dEC);
-    
-    cp_dPC  = g_scdRE * cp_dA_0 / (cp_dB_0 * cp_dB_0);
-    cp_dPC  = 1.5 * g_scdJ2 * cp_dPC * cp_dPC * cp_dMM;
-    
-    l_dCI = cos(cp_dIN);
-    cp_dQD = -cp_dPC * l_dCI;
-    cp_dWD =  cp_dPC * (5.0 * l_dCI * l_dCI - 1.0) / 2.0;
-    cp_dDC = -2.0 * cp_dM2 / (3.0 * cp_dMM);
-}
-
-
-void P13Satellite::predict(const P13DateTime &p_dt) {
-    
-    long   l_lDN;
-    
-    double l_dTN;
-    double l_dGHAE, l_dGHAA;
-    double l_dT, l_dDT, l_dKD, l_dKDP;
-    double l_dM, l_dDR, l_dEA;
-    double l_dDNOM, l_dC_EA, l_dS_EA;
-    double l_dA, l_dB, l_dD;
-    double l_dAP, l_dCW, l_dSW;
-    double l_dRAAN;
-    double l_dCQ, l_dSQ;
-    double l_dCI, l_dSI;
-    double l_dCG, l_dSG;
-    
-    Vec3 l_vecCX, l_vecCY, l_vecCZ;
-    
-    l_lDN = p_dt.c_lDN;
-    l_dTN = p_dt.c_dTN;
-
-    l_dGHAE = radians(g_scdG0) + ((double)(cp_lDE - fnday(g_scdYG, 1, 0)) + cp_dTE) * g_scdWE;    // GHA Aries, epoch
-
-    l_dT   = (double)(l_lDN - cp_lDE) + (l_dTN - cp_dTE);    // Elapsed T since epoch, days
-    l_dDT  = cp_dDC * l_dT / 2.0;                            // Linear drag terms
-    l_dKD  = 1.0 + 4.0 * l_dDT;                              // -"-
-    l_dKDP = 1.0 - 7.0 * l_dDT;                              // -"-
-  
-    l_dM   = cp_dMA + cp_dMM * l_dT * (1.0 - 3.0 * l_dDT);   // Mean anomaly at YR,TN
-    l_dDR  = (long)(l_dM / (2.0 * PI));                      // Strip out whole no of revs
-    l_dM  -= l_dDR * 2.0 * PI;                               // M now in range 0..2PI
-    
-    // Solve M = EA - EC*SIN(EA) for EA given M, by Newton's Method
-    l_dEA  = l_dM;                                           // Initial solution
-
-    do
-    {
-        l_dC_EA = cos(l_dEA);
-        l_dS_EA = sin(l_dEA);
-        l_dDNOM = 1.0 - cp_dEC * l_dC_EA;
-        l_dD = (l_dEA - cp_dEC * l_dS_EA - l_dM) / l_dDNOM;  // Change to EA for better solution
-        l_dEA -= l_dD ;                                      // by this amount
-    }
-    while (fabs(l_dD) > 1.0E-5);
-
-    // Distances
-    l_dA = cp_dA_0 * l_dKD;           
-    l_dB = cp_dB_0 * l_dKD;
-    cp_dRS = l_dA * l_dDNOM;
-
-    // Calc satellite position & velocity in plane of ellipse
-    c_vecS[0] = l_dA * (l_dC_EA - cp_dEC);
-    c_vecS[1] = l_dB * l_dS_EA;
-    
-    c_vecV[0] = -l_dA * l_dS_EA / l_dDNOM * cp_dN0;
-    c_vecV[1] =  l_dB * l_dC_EA / l_dDNOM * cp_dN0;
-
-    l_dAP = cp_dWP + cp_dWD * l_dT * l_dKDP;
-    l_dCW = cos(l_dAP);
-    l_dSW = sin(l_dAP);
-    l_dRAAN = cp_dRA + cp_dQD * l_dT * l_dKDP;
-    l_dCQ = cos(l_dRAAN);
-    l_dSQ = sin(l_dRAAN);
-
-    // CX, CY, and CZ form a 3x3 matrix that converts between orbit
-    // coordinates, and celestial coordinates.
-    
-    // Plane -> celestial coordinate transformation, [C] = [RAAN]*[IN]*[AP]
-    l_dCI = cos(cp_dIN);
-    l_dSI = sin(cp_dIN);    
-   
-    l_vecCX[0] =  l_dCW * l_dCQ - l_dSW * l_dCI * l_dSQ;
-    l_vecCX[1] = -l_dSW * l_dCQ - l_dCW * l_dCI * l_dSQ;
-    l_vecCX[2] =  l_dSI * l_dSQ;
-
-    l_vecCY[0] =  l_dCW * l_dSQ + l_dSW * l_dCI * l_dCQ;
-    l_vecCY[1] = -l_dSW * l_dSQ + l_dCW * l_dCI * l_dCQ;
-    l_vecCY[2] = -l_dSI * l_dCQ;
-
-    l_vecCZ[0] = l_dSW * l_dSI;
-    l_vecCZ[1] = l_dCW * l_dSI;
-    l_vecCZ[2] = l_dCI;
-
-    // Compute SATellite's position vector and VELocity in
-    // CELESTIAL coordinates. (Note: Sz=S[2]=0, Vz=V[2]=0)
-    c_vecSAT[0] = c_vecS[0] * l_vecCX[0] + c_vecS[1] * l_vecCX[1];
-    c_vecSAT[1] = c_vecS[0] * l_vecCY[0] + c_vecS[1] * l_vecCY[1];
-    c_vecSAT[2] = c_vecS[0] * l_vecCZ[0] + c_vecS[1] * l_vecCZ[1];
-
-    c_vecVEL[0] = c_vecV[0] * l_vecCX[0] + c_vecV[1] * l_vecCX[1];
-    c_vecVEL[1] = c_vecV[0] * l_vecCY[0] + c_vecV[1] * l_vecCY[1];
-    c_vecVEL[2] = c_vecV[0] * l_vecCZ[0] + c_vecV[1] * l_vecCZ[1];
-
-    // Also express SAT and VEL in GEOCENTRIC coordinates:
-    l_dGHAA = (l_dGHAE + g_scdWE * l_dT); // GHA Aries at elapsed time T
-    l_dCG   = cos(-l_dGHAA);
-    l_dSG   = sin(-l_dGHAA);
-
-    c_vecS[0] = c_vecSAT[0] * l_dCG - c_vecSAT[1] * l_dSG;
-    c_vecS[1] = c_vecSAT[0] * l_dSG + c_vecSAT[1] * l_dCG;
-    c_vecS[2] = c_vecSAT[2];
-
-    c_vecV[0] = c_vecVEL[0] * l_dCG - c_vecVEL[1]* l_dSG;
-    c_vecV[1] = c_vecVEL[0] * l_dSG + c_vecVEL[1]* l_dCG;
-    c_vecV[2] = c_vecVEL[2];
-}
-
-
-void P13Satellite::latlon(double &p_dlat, double &p_dlon) {
-    
-    p_dlat = degrees(asin(c_vecS[2] / cp_dRS));
-    p_dlon = degrees(atan2(c_vecS[1], c_vecS[0]));
-}
-
-
-void P13Satellite::elaz(const P13Observer &p_obs, double &p_del, double &p_daz) {
-    
-    double l_dr, l_du, l_de, l_dn;
-    
-    Vec3 l_vecR; // Rangevec
-
-    
-    // Rangevec = Satvec - Obsvec
-    l_vecR[0] = c_vecS[0] - p_obs.c_vecO[0];
-    l_vecR[1] = c_vecS[1] - p_obs.c_vecO[1];
-    l_vecR[2] = c_vecS[2] - p_obs.c_vecO[2];
-    
-    // Range magnitude
-    l_dr = sqrt(l_vecR[0] * l_vecR[0] + l_vecR[1] * l_vecR[1] + l_vecR[2] * l_vecR[2]);
-    
-    // Normalise Range vector
-    l_vecR[0] /= l_dr;
-    l_vecR[1] /= l_dr;
-    l_vecR[2] /= l_dr;
-    
-    // UP Component of unit range
-    l_du = l_vecR[0] * p_obs.c_vecU[0] + l_vecR[1] * p_obs.c_vecU[1] + l_vecR[2] * p_obs.c_vecU[2];
-    // EAST
-    l_de = l_vecR[0] * p_obs.c_vecE[0] + l_vecR[1] * p_obs.c_vecE[1];
-    //NORTH
-    l_dn = l_vecR[0] * p_obs.c_vecN[0] + l_vecR[1] * p_obs.c_vecN[1] + l_vecR[2] * p_obs.c_vecN[2];
-    
-    // Azimuth
-    p_daz = degrees(atan2(l_de, l_dn));
-    
-    if (p_daz < 0.0)
-        p_daz += 360.0;
-    
-    // Elevation
-    p_del = degrees(asin(l_du));
-    
-    // Calculate range rate needed for doppler calculation
-    // Resolve Sat-Obs velocity vector along unit range vector. (VOz=obs.V[2]=0)
-    cp_dRR  = (c_vecV[0] - p_obs.c_vecV[0]) * l_vecR[0] + (c_vecV[1] - p_obs.c_vecV[1]) * l_vecR[1] + c_vecV[2] * l_vecR[2];    // Range rate, km/s
-    
-}
-
-// Generates the footprint for a satellite at satlat/satlon and calculates rectangular
-// x/y coordinates scaled to a map with size MapMaxX/MapMaxY. The coordinates are stored
-// in a two dimensional array. points[n][0] stores x and points[n][1] stores y.
-// The coordinates can be concatenated with lines to create a footprint outline.
-void P13Satellite::footprint(int p_aipoints[][2], int p_inumberofpoints, const int p_ciMapMaxX, const int p_ciMapMaxY, double &p_dsatlat, double &p_dsatlon) {
-
-    int l_ii;
-    
-    double l_dsrad;
-    double l_dcla, l_dsla, l_dclo, l_dslo;
-    double l_dsra, l_dcra;
-    
-    double l_da, l_dx, l_dy, l_dz, l_dXfp, l_dYfp, l_dZfp;
-    
-        
-    l_dsrad = acos(g_scdRE / cp_dRS);  // Radius of footprint circle
-    l_dsra  = sin(l_dsrad);            // Sin/Cos these to save time
-    l_dcra  = cos(l_dsrad);
-
-    l_dcla  = cos(radians(p_dsatlat));
-    l_dsla  = sin(radians(p_dsatlat));
-    l_dclo  = cos(radians(p_dsatlon));
-    l_dslo  = sin(radians(p_dsatlon));
-    
-    for ( l_ii = 0; l_ii < p_inumberofpoints ; l_ii++)               // "numberofpoints" points to the circle
-    {
-        l_da = 2.0 * PI * (double)l_ii / (double)p_inumberofpoints;  // Angle around the circle
-        l_dXfp = l_dcra;                                             // Circle of points centred on Lat=0, Lon=0
-        l_dYfp = l_dsra * sin(l_da);                                 // assuming Earth's radius = 1
-        l_dZfp = l_dsra * cos(l_da);
-        
-        l_dx   = l_dXfp * l_dcla - l_dZfp * l_dsla;                  // Rotate point "up" by latitude "satlat"
-        l_dy   = l_dYfp;                                             // -"-
-        l_dz   = l_dXfp * l_dsla + l_dZfp * l_dcla;                  // -"-
-        
-        l_dXfp = l_dx * l_dclo - l_dy * l_dslo;                      // Rotate point "around" through longitude "satlon"
-        l_dYfp = l_dx * l_dslo + l_dy * l_dclo;                      // -"-
-        l_dZfp = l_dz;                                               // -"-
-        
-        // Convert point to Lat/Lon and convert/scale to a pixel map
-        latlon2xy(p_aipoints[l_ii][0], p_aipoints[l_ii][1], degrees(asin(l_dZfp)), degrees(atan2(l_dYfp,l_dXfp)), p_ciMapMaxX, p_ciMapMaxY);
-    }
-
-}
-
-// Returns the RX (dir = 0 or P13_FRX) or TX (dir = 1 or P13_FTX) frequency with doppler shift.
-double P13Satellite::doppler(double p_dfreqMHz, bool p_bodir) {
-    
-    double l_ddopplershift = dopplerOffset(p_dfreqMHz);
-    
-    if (p_bodir)  // TX
-    {
-        p_dfreqMHz = p_dfreqMHz - l_ddopplershift;
-    }
-    else          // RX
-    {
-        p_dfreqMHz = p_dfreqMHz + l_ddopplershift;
-    }
-
-    return (p_dfreqMHz);
-
-}
-
-// Returns just the change in frequency, relative to the observer, due to doppler shift.
-double P13Satellite::dopplerOffset(double p_dfreqMHz) {
-    return -p_dfreqMHz * cp_dRR / 299792.0;    //  Speed of light is 299792.0 km/s
-}
-
-
-//----------------------------------------------------------------------
-//     _              ___  _ _______           
-//  __| |__ _ ______ | _ \/ |__ / __|_  _ _  _  
-// / _| / _` (_-<_-< |  _/| ||_ \__ \ || | \| |
-// \__|_\__,_/__/__/ |_|  |_|___/___/\_,_|_|\_|
-//                                             
-//----------------------------------------------------------------------
-
-P13Sun::P13Sun() {
-    
-}
-
-
-P13Sun::~P13Sun() {
-    
-}
-
-
-void P13Sun::predict(const P13DateTime &p_dt) {
-    
-    long   l_lDN;
-    
-    double l_dTN;
-    double l_dT, l_dGHAE, l_dMRSE, l_dMASE, l_dTAS;
-    double l_dC, l_dS;
-    
-    l_lDN = p_dt.c_lDN;
-    l_dTN = p_dt.c_dTN;
-
-    l_dT    = (double)(l_lDN - fnday(g_scdYG, 1, 0)) + l_dTN;
-    l_dGHAE = radians(g_scdG0) + l_dT * g_scdWE;
-        
-    l_dMRSE = radians(g_scdG0) + l_dT * g_scdWW + PI;
-    l_dMASE = radians(g_scdMAS0 + l_dT * g_scdMASD);
-    l_dTAS  = l_dMRSE + g_scdEQC1 * sin(l_dMASE) + g_scdEQC2 * sin(2.0 * l_dMASE);
-
-    // Sin/Cos Sun's true anomaly
-    l_dC = cos(l_dTAS);
-    l_dS = sin(l_dTAS);
-
-    // Sun unit vector - CELESTIAL coords
-    c_vecSUN[0] = l_dC;
-    c_vecSUN[1] = l_dS * g_scdCNS;
-    c_vecSUN[2] = l_dS * g_scdSNS;
-    
-    // Obtain SUN unit vector in GEOCENTRIC coordinates
-    l_dC = cos(-l_dGHAE); 
-    l_dS = sin(-l_dGHAE); 
-        
-    c_vecH[0] = c_vecSUN[0] * l_dC - c_vecSUN[1] * l_dS;
-    c_vecH[1] = c_vecSUN[0] * l_dS + c_vecSUN[1] * l_dC;
-    c_vecH[2] = c_vecSUN[2];
-}
-
-
-void P13Sun::latlon(double &p_dlat, double &p_dlon) {
-    
-    p_dlat = degrees(asin(c_vecH[2]));
-    p_dlon = degrees(atan2(c_vecH[1], c_vecH[0]));
-}
-
-
-void P13Sun::elaz(const P13Observer &p_obs, double &p_del, double &p_daz) {
-    
-    // Copyright (c) 2021 Uwe Nagel
-    
-    double l_dr, l_du, l_de, l_dn;
-    
-	Vec3 l_vecR; // Rangevec
-    
-    // Rangevec = Satvec - Obsvec
-    l_vecR[0] = c_vecH[0] * g_scdAU - p_obs.c_vecO[0] ;
-    l_vecR[1] = c_vecH[1] * g_scdAU - p_obs.c_vecO[1] ;
-    l_vecR[2] = c_vecH[2] * g_scdAU - p_obs.c_vecO[2] ;
-    
-    // Range magnitude
-    l_dr = sqrt(l_vecR[0] * l_vecR[0] + l_vecR[1] * l_vecR[1] + l_vecR[2] * l_vecR[2]);
-    
-    // Normalise Range vector
-    l_vecR[0] /= l_dr;
-    l_vecR[1] /= l_dr;
-    l_vecR[2] /= l_dr;
-    
-    // UP Component of unit range
-    l_du = l_vecR[0] * p_obs.c_vecU[0] + l_vecR[1] * p_obs.c_vecU[1] + l_vecR[2] * p_obs.c_vecU[2];
-    // EAST
-    l_de = l_vecR[0] * p_obs.c_vecE[0] + l_vecR[1] * p_obs.c_vecE[1];
-    //NORTH
-    l_dn = l_vecR[0] * p_obs.c_vecN[0] + l_vecR[1] * p_obs.c_vecN[1] + l_vecR[2] * p_obs.c_vecN[2];
-    
-    // Azimuth
-    p_daz = degrees(atan2(l_de, l_dn));
-
-    if (p_daz < 0.0)
-        p_daz += 360.0;
-    
-    // Elevation
-    p_del = degrees(asin(l_du));
-
-}
-
-
-// Generates the sunlight footprint at satlat/satlon and calculates rectangular
-// x/y coordinates scaled to a map with size MapMaxX/MapMaxY. The coordinates are stored
-// in a two dimensional array. points[n][0] stores x and points[n][1] stores y.
-// The coordinates can be concatenated with lines to create a footprint outline.
-//
-// This is a simplified aproach with no real calculation of the distance to the sun at a
-// specific time. It is assumed that the nearest and farest distance of the sun makes almost no
-// difference in footprint radius, it is always almost 0.5*PI. Therefore one astronomical
-// unit is used for the distance. The same algorithm is used as for the satellite footprint
-// except, that RS is replaced by AU.
-void P13Sun::footprint(int p_aipoints[][2], int p_inumberofpoints, const int p_ciMapMaxX, const int p_ciMapMaxY, double &p_dsunlat, double &p_dsunlon) {
-
-    int l_ii;
-    
-    double l_dsrad;
-    double l_dcla, l_dsla, l_dclo, l_dslo;
-    double l_dsra, l_dcra;
-    
-    double l_da, l_dx, l_dy, l_dz, l_dXfp, l_dYfp, l_dZfp;
-    
-        
-    l_dsrad = acos(g_scdRE / g_scdAU);  // Radius of sunlight footprint circle
-    l_dsra  = sin(l_dsrad);             // Sin/Cos these to save time
-    l_dcra  = cos(l_dsrad);
-
-    l_dcla  = cos(radians(p_dsunlat));
-    l_dsla  = sin(radians(p_dsunlat));
-    l_dclo  = cos(radians(p_dsunlon));
-    l_dslo  = sin(radians(p_dsunlon));
-    
-    for ( l_ii = 0; l_ii < p_inumberofpoints ; l_ii++)  // "numberofpoints" points to the circle
-    {
-        l_da = 2.0 * PI * (double)l_ii / (double)p_inumberofpoints;  // Angle around the circle
-        l_dXfp = l_dcra;                                             // Circle of points centred on Lat=0, Lon=0
-        l_dYfp = l_dsra * sin(l_da);                                 // assuming Earth's radius = 1
-        l_dZfp = l_dsra * cos(l_da);
-        
-        l_dx   = l_dXfp * l_dcla - l_dZfp * l_dsla;                  // Rotate point "up" by latitude "sunlat"
-        l_dy   = l_dYfp;                                             // -"-
-        l_dz   = l_dXfp * l_dsla + l_dZfp * l_dcla;                  // -"-
-        
-        l_dXfp = l_dx * l_dclo - l_dy * l_dslo;                      // Rotate point "around" through longitude "sunlon"
-        l_dYfp = l_dx * l_dslo + l_dy * l_dclo;                      // -"-
-        l_dZfp = l_dz;                                               // -"-
-        
-        // Convert point to Lat/Lon and convert/scale to a pixel map
-        latlon2xy(p_aipoints[l_ii][0], p_aipoints[l_ii][1], degrees(asin(l_dZfp)), degrees(atan2(l_dYfp,l_dXfp)), p_ciMapMaxX, p_ciMapMaxY);
-    }
-
-}
+//
+// AioP13.cpp
+//
+// An implementation of Plan13 in C++ by Mark VandeWettering
+//
+// Plan13 is an algorithm for satellite orbit prediction first formulated
+// by James Miller G3RUH.  I learned about it when I saw it was the basis 
+// of the PIC based antenna rotator project designed by G6LVB.
+//
+// http://www.g6lvb.com/Articles/LVBTracker2/index.htm
+//
+// I ported the algorithm to Python, and it was my primary means of orbit
+// prediction for a couple of years while I operated the "Easy Sats" with 
+// a dual band hand held and an Arrow antenna.
+//
+// I've long wanted to redo the work in C++ so that I could port the code
+// to smaller processors including the Atmel AVR chips.  Bruce Robertson,
+// VE9QRP started the qrpTracker project to fulfill many of the same goals,
+// but I thought that the code could be made more compact and more modular,
+// and could serve not just the embedded targets but could be of more
+// use for more general applications.  And, I like the BSD License a bit
+// better too.
+//
+// So, here it is!
+//
+// =====================================================================
+//
+// dl9sec@gmx.net (02..11/2021):
+//
+// The original Plan13 BBC Basic source code can be found at:
+//
+// https://www.amsat.org/articles/g3ruh/111.html
+//
+// Published as "Donationware" in favour of AMSAT-UK, LONDON, E12 5EQ
+// and the AO-13 Amateur Satellite Program.
+//
+// Changes:
+// - Refactoring for seamless use with Arduino.
+// - Renamed class DateTime to P13DateTime because of potential conflict
+//   with RTClib, which uses the same class name.
+// - Renamed all classes to P13... for consistency and clarification of
+//   affiliation.
+// - Some code beautification.
+// - Changed output of method "ascii" to ISO date format
+// - Added helper function for converting lat/lon coordinates to rectangular
+//   map coordinates
+// - Used all double (see P13Real for single precision)
+// - Used PI instead of M_PI
+// - Used degrees() and radians() instead of DEGREES() and RADIANS()
+// - Inserted explicit casts
+// - Added a method "footprint" to class P13Satellite
+// - Added a method "doppler" to calculate down- and uplink frequencies
+// - Added a method "footprint" to class P13Sun
+// - Added implementation suggestion for P13Sun:elaz() by Uwe Nagel
+// - Renamed the whole stuff from ArduinoP13 to AioP13 to follow the
+//   Arduino library specifications for naming of libraries.
+// - Rework of all the variable names because of conflicts.
+//   All variables got a qualifier to get more or less unique names:
+//   "g_": global variables
+//   "c_": class public variables
+//   "cp_": class private variables
+//   "p_": parameter variable
+//   "l_": local variable
+//   The next letter gives a hint about the data type (e.g. "d": double,
+//   "i": integer, "cc": constant character, "vec": Vec3 vector, ...).
+//   In some cases this is very ugly, so all the variables should be renamed
+//   to speaking and useful names in one of the next releases.
+//
+// Uwe Nagel (09/2021)
+//
+// - Implementation of P13Sun:elaz()
+//
+// Mark Smith @SmittyHalibut (12/2021)
+//
+// - Added some helper constants, cleaned up compiler warnings.
+// - Copy Observer and Satellite name strings instead of assuming 
+//   the source is always there.
+// - Added `dopplerOffset()`
+//
+//----------------------------------------------------------------------
+
+#include "AioP13.h"
+
+#if defined(P13_PROFILE) && !defined(ARDUINO)
+  #include <chrono>
+#endif
+
+#if defined(ARDUINO_ARCH_ESP32)
+  #include "freertos/FreeRTOS.h"
+  #include "freertos/task.h"
+  #include "freertos/semphr.h"
+#elif defined(P13_THREADS) && !defined(ARDUINO)
+  #include <thread>
+#endif
+
+
+//----------------------------------------------------------------------
+//  _  _     _                  __              _   _             
+// | || |___| |_ __  ___ _ _   / _|_  _ _ _  __| |_(_)___ _ _  ___
+// | __ / -_) | '_ \/ -_) '_| |  _| || | ' \/ _|  _| / _ \ ' \(_-<
+// |_||_\___|_| .__/\___|_|   |_|  \_,_|_||_\__|\__|_\___/_||_/__/
+//            |_|                                                 
+//
+//----------------------------------------------------------------------
+
+// Convert date to day-number
+static long fnday(int p_iy, int p_im, int p_id) {
+    
+    if ( p_im < 3 )
+    {
+        p_im += 12;
+        p_iy--;
+    }
+    
+    // Integer form of (long)(Y * 365.25) + (long)((M + 1) * 30.6)
+    return ((long)p_iy * 36525L / 100L + (long)(p_im + 1) * 306L / 10L + (long)(p_id - 428));
+}
+
+
+// Convert day-number to date; valid 1900 Mar 01 - 2100 Feb 28. Integer form of
+// Y = (DN - 122.1) / 365.25 and M = DN / 30.61, none of the quotients can be an
+// integer, so the results are the same as in floating point.
+static void fndate(int &p_iy, int &p_im, int &p_id, long p_idt) {
+    
+    p_idt += 428L;
+    p_iy   = (int)((p_idt * 100L - 12210L) / 36525L);
+    p_idt -= (long)p_iy * 36525L / 100L;
+    p_im   = (int)(p_idt * 100L / 3061L);
+    p_idt -= (long)p_im * 306L / 10L;
+    p_im--;
+    
+    if ( p_im > 12 )
+    {
+        p_im -= 12;
+        p_iy++;
+    }
+    
+    p_id = (int)p_idt;
+}
+
+
+// Returns the seconds of the day of TN. 1 us is added against the rounding of TN, else
+// e.g. 12:34:56 from settime() would be read back as 12:34:55.
+static long fnsecofday(double p_dtn) {
+    
+    return ((long)(p_dtn * 86400.0 + 1.0E-6));
+}
+
+
+// Writes n digits of v with leading zeros
+static char *fndigits(char *p_cbuf, int p_iv, int p_in) {
+    
+    int l_ii;
+    
+    for ( l_ii = p_in - 1; l_ii >= 0; l_ii-- )
+    {
+        p_cbuf[l_ii] = '0' + (p_iv % 10);
+        p_iv /= 10;
+    }
+    
+    return (p_cbuf + p_in);
+}
+
+
+static const double g_scdPOW10[10] = { 1.0E0, 1.0E1, 1.0E2, 1.0E3, 1.0E4, 1.0E5, 1.0E6, 1.0E7, 1.0E8, 1.0E9 };
+
+// Convert characters from c with start i0 to i1-1 to double. The columns are
+// parsed in place (fixed point with optional sign and leading blanks), so no
+// copy of the field and no strtod() is needed.
+static double getdouble(const char *p_ccc, int p_ii0, int p_ii1) {
+    
+    long  l_lint  = 0L;
+    long  l_lfrac = 0L;
+    int   l_ifrac = 0;
+    bool  l_bneg  = false;
+    bool  l_bdot  = false;
+    char  l_c;
+    
+    for ( ; p_ii0 < p_ii1; p_ii0++ )
+    {
+        l_c = p_ccc[p_ii0];
+        
+        if ( (l_c >= '0') && (l_c <= '9') )
+        {
+            if ( !l_bdot )
+                l_lint = l_lint * 10L + (long)(l_c - '0');
+            else if ( l_ifrac < 9 )
+            {
+                l_lfrac = l_lfrac * 10L + (long)(l_c - '0');
+                l_ifrac++;
+            }
+        }
+        else if ( l_c == '.' )
+            l_bdot = true;
+        else if ( l_c == '-' )
+            l_bneg = true;
+    }
+    
+    return ((l_bneg ? -1.0 : 1.0) * ((double)l_lint + (double)l_lfrac / g_scdPOW10[l_ifrac]));
+}
+
+
+// Convert characters from c with start i0 to i1-1 to long, parsed in place
+static long getlong(const char *p_ccc, int p_ii0, int p_ii1) {
+    
+    long l_l    = 0L;
+    bool l_bneg = false;
+    char l_c;
+    
+    for ( ; p_ii0 < p_ii1; p_ii0++ )
+    {
+        l_c = p_ccc[p_ii0];
+        
+        if ( (l_c >= '0') && (l_c <= '9') )
+            l_l = l_l * 10L + (long)(l_c - '0');
+        else if ( l_c == '-' )
+            l_bneg = true;
+    }
+    
+    return (l_bneg ? -l_l : l_l);
+}
+
+
+// Convert the exponential field of a TLE from c with start i0 to i1-1 to double. The
+// mantissa has an implied leading decimal point, the last two characters are the
+// exponent (e.g. " 31985-4" = 0.31985E-4).
+static double getexp(const char *p_ccc, int p_ii0, int p_ii1) {
+    
+    return (getdouble(p_ccc, p_ii0, p_ii1 - 2) / g_scdPOW10[p_ii1 - 2 - p_ii0 - 1] * pow(10.0, (double)getlong(p_ccc, p_ii1 - 2, p_ii1)));
+}
+
+
+// Check the modulo 10 checksum of a TLE line (digits count by value, '-' counts 1)
+static bool tlechecksum(const char *p_ccl) {
+    
+    int l_ii, l_isum = 0;
+    
+    for ( l_ii = 0; l_ii < 68; l_ii++ )
+    {
+        if ( (p_ccl[l_ii] >= '0') && (p_ccl[l_ii] <= '9') )
+            l_isum += p_ccl[l_ii] - '0';
+        else if ( p_ccl[l_ii] == '-' )
+            l_isum++;
+    }
+    
+    return ((l_isum % 10) == (p_ccl[68] - '0'));
+}
+
+
+// Mean elements of a TLE and the quantities derived from them
+struct P13Elements {
+    long   c_lN, c_lYE, c_lDE;
+    double c_dTE, c_dIN, c_dRA, c_dEC, c_dWP, c_dMA, c_dMM, c_dM2, c_dRV, c_dBS;
+    double c_dN0, c_dA_0, c_dB_0, c_dPC, c_dQD, c_dWD, c_dDC;
+    double c_dGHAE, c_dCI, c_dSI;
+};
+
+
+#ifdef P13_NAME_INLINE
+// Stores a name in a buffer of P13_NAME_LEN + 1 characters, longer names are truncated
+static void fnname(char *p_acname, const char *p_ccnm) {
+    
+    size_t l_uilen = min(strlen(p_ccnm), (size_t)P13_NAME_LEN);
+    
+    memcpy(p_acname, p_ccnm, l_uilen);
+    p_acname[l_uilen] = '\0';
+}
+#else
+// Empty name left behind in an object after a move, not on the heap
+static char g_sacNoName[1] = "";
+
+
+// Frees a name buffer from fnname()
+static void fnnamefree(char *p_pcname) {
+    
+    if ( p_pcname != g_sacNoName )
+        delete[] p_pcname;
+}
+
+
+// Stores a name in a buffer on the heap. The buffer is reused if the name fits, else
+// it is replaced by a new one with the length of the name (max. 255 characters).
+static void fnname(char *&p_pcname, const char *p_ccnm) {
+    
+    size_t l_uilen = strlen(p_ccnm) % 256;
+    
+    if ( !p_pcname || (p_pcname == g_sacNoName) || (strlen(p_pcname) < l_uilen) )
+    {
+        fnnamefree(p_pcname);
+        p_pcname = new char[l_uilen + 1];
+    }
+    
+    memcpy(p_pcname, p_ccnm, l_uilen);
+    p_pcname[l_uilen] = '\0';
+}
+#endif
+
+
+// Get the elements from the two TLE lines with lengths len1/len2 (without line end).
+// Returns P13_TLE_EFORMAT (elements not touched) if the lines are not a valid TLE
+// pair, P13_TLE_ECHECKSUM if one of the checksums does not match, else P13_TLE_OK.
+// Lines of 68 characters without the checksum digit are accepted as they are.
+static int tleparse(P13Elements &p_el, const char *p_ccl1, size_t p_uilen1, const char *p_ccl2, size_t p_uilen2) {
+    
+    double l_dCI;
+    
+    if ( (p_uilen1 < 68) || (p_uilen2 < 68) || (p_ccl1[0] != '1') || (p_ccl2[0] != '2') ||
+         (p_ccl1[1] != ' ') || (p_ccl2[1] != ' ') || strncmp(&p_ccl1[2], &p_ccl2[2], 5) )
+        return (P13_TLE_EFORMAT);
+
+    // Direct quantities from the orbital elements
+
+    p_el.c_lN  = getlong(p_ccl1,  2,  7);               // Get satellite catalog number from tle:l1:2..6
+    p_el.c_lYE = getlong(p_ccl1, 18, 20);               // Get epoch year from tle:l1:18..19
+        
+    if ( p_el.c_lYE < 58 )
+        p_el.c_lYE += 2000;
+    else
+        p_el.c_lYE += 1900;
+
+    p_el.c_dTE = getdouble(p_ccl1, 20, 32);             // Get epoch (day of the year and fractional portion of the day) from tle:l1:20..31
+    p_el.c_dM2 = 2.0 * PI * getdouble(p_ccl1, 33, 43);  // Get first time derivative of the mean motion divided by to from tle:l1:33..42
+    p_el.c_dBS = getexp(p_ccl1, 53, 61);                // Get B* drag term from tle:l1:53..60
+
+    p_el.c_dIN = radians(getdouble(p_ccl2, 8, 16));     // Get inclination (degrees) from tle:l2:8..15
+    p_el.c_dRA = radians(getdouble(p_ccl2, 17, 25));    // Get R.A.A.N (degrees) from tle:l2:17..24
+    p_el.c_dEC = getdouble(p_ccl2, 26, 33) / 1.0E7;     // Get eccentricity from tle:l2:26..32
+    p_el.c_dWP = radians(getdouble(p_ccl2, 34, 42));    // Get argument of perigee (degrees) from tle:l2:34..41
+    p_el.c_dMA = radians(getdouble(p_ccl2, 43, 51));    // Get mean anomaly (degrees) from tle:l2:43..50
+    p_el.c_dMM = 2.0 * PI * getdouble(p_ccl2, 52, 63);  // Get mean motion from tle:l2:52..62
+    p_el.c_dRV = getlong(p_ccl2, 63, 68);               // Get Revolution number at epoch (revolutions) from tle:l2:63..67
+
+    // Derived quantities from the orbital elements 
+
+    // convert TE to DE and TE 
+    p_el.c_lDE = fnday(p_el.c_lYE, 1, 0) + (long)p_el.c_dTE;
+    
+    p_el.c_dTE -= (long)p_el.c_dTE;
+
+    p_el.c_dN0  = p_el.c_dMM / 86400.0;
+    p_el.c_dA_0 = pow(g_scdGM / (p_el.c_dN0 * p_el.c_dN0), 1.0/3.0);
+    p_el.c_dB_0 = p_el.c_dA_0 * sqrt(1.0 - p_el.c_dEC * p_el.c_dEC);
+    
+    p_el.c_dPC  = g_scdRE * p_el.c_dA_0 / (p_el.c_dB_0 * p_el.c_dB_0);
+    p_el.c_dPC  = 1.5 * g_scdJ2 * p_el.c_dPC * p_el.c_dPC * p_el.c_dMM;
+    
+    l_dCI = cos(p_el.c_dIN);
+    p_el.c_dQD = -p_el.c_dPC * l_dCI;
+    p_el.c_dWD =  p_el.c_dPC * (5.0 * l_dCI * l_dCI - 1.0) / 2.0;
+    p_el.c_dDC = -2.0 * p_el.c_dM2 / (3.0 * p_el.c_dMM);
+    
+    // Epoch constants for predict()
+    p_el.c_dGHAE = radians(g_scdG0) + ((double)(p_el.c_lDE - g_sclDNG) + p_el.c_dTE) * g_scdWE;  // GHA Aries, epoch
+    p_el.c_dCI   = l_dCI;
+    p_el.c_dSI   = sin(p_el.c_dIN);
+    
+    if ( ((p_uilen1 > 68) && !tlechecksum(p_ccl1)) || ((p_uilen2 > 68) && !tlechecksum(p_ccl2)) )
+        return (P13_TLE_ECHECKSUM);
+    
+    return (P13_TLE_OK);
+}
+
+
+// Layout of a binary element record, see P13_REC_SIZE
+static const uint8_t g_scuiRECDBL    = 20;    // Number of doubles
+static const size_t  g_scuiRECINT    = 160;   // Offset of the int32 fields
+static const size_t  g_scuiRECNAME   = 172;   // Offset of the name
+static const size_t  g_scuiRECNMLEN  = 24;    // Length of the name
+static const size_t  g_scuiRECTAG    = 196;   // Offset of tag, version and sum
+
+// The doubles of a binary element record in their order
+static double P13Elements::*const g_scapdREC[g_scuiRECDBL] = {
+    &P13Elements::c_dTE, &P13Elements::c_dIN, &P13Elements::c_dRA, &P13Elements::c_dEC,
+    &P13Elements::c_dWP, &P13Elements::c_dMA, &P13Elements::c_dMM, &P13Elements::c_dM2,
+    &P13Elements::c_dRV, &P13Elements::c_dBS, &P13Elements::c_dN0, &P13Elements::c_dA_0,
+    &P13Elements::c_dB_0, &P13Elements::c_dPC, &P13Elements::c_dQD, &P13Elements::c_dWD,
+    &P13Elements::c_dDC, &P13Elements::c_dGHAE, &P13Elements::c_dCI, &P13Elements::c_dSI
+};
+
+
+// Reads an unsigned 32 bit number (little endian)
+static uint32_t fnrecget32(const uint8_t *p_au) {
+    
+    return ((uint32_t)p_au[0] | ((uint32_t)p_au[1] << 8) | ((uint32_t)p_au[2] << 16) | ((uint32_t)p_au[3] << 24));
+}
+
+
+// Writes an unsigned 32 bit number (little endian)
+static void fnrecput32(uint8_t *p_au, uint32_t p_ul) {
+    
+    p_au[0] = (uint8_t)p_ul;
+    p_au[1] = (uint8_t)(p_ul >> 8);
+    p_au[2] = (uint8_t)(p_ul >> 16);
+    p_au[3] = (uint8_t)(p_ul >> 24);
+}
+
+
+// Reads an IEEE 754 binary64 (little endian). Where double has 32 bit (AVR) the
+// mantissa is truncated to 24 bit, the exponents of the elements fit into float.
+static double fnrecgetd(const uint8_t *p_au) {
+    
+#if __SIZEOF_DOUBLE__ == 8
+    uint64_t l_ull = (uint64_t)fnrecget32(p_au) | ((uint64_t)fnrecget32(&p_au[4]) << 32);
+    double   l_d;
+    
+    memcpy(&l_d, &l_ull, sizeof(l_d));
+    
+    return (l_d);
+#else
+    uint32_t l_ullo = fnrecget32(p_au);
+    uint32_t l_ulhi = fnrecget32(&p_au[4]);
+    int      l_iexp = (int)((l_ulhi >> 20) & 0x7FF);
+    double   l_d;
+    
+    if ( l_iexp == 0 )
+        return (0.0);
+    
+    l_d = ldexp(1.0 + (double)(((l_ulhi & 0xFFFFFUL) << 3) | (l_ullo >> 29)) / 8388608.0, l_iexp - 1023);
+    
+    return ((l_ulhi & 0x80000000UL) ? -l_d : l_d);
+#endif
+}
+
+
+// Writes an IEEE 754 binary64 (little endian), also where double has 32 bit (AVR)
+static void fnrecputd(uint8_t *p_au, double p_d) {
+    
+#if __SIZEOF_DOUBLE__ == 8
+    uint64_t l_ull;
+    
+    memcpy(&l_ull, &p_d, sizeof(l_ull));
+    
+    fnrecput32(p_au, (uint32_t)l_ull);
+    fnrecput32(&p_au[4], (uint32_t)(l_ull >> 32));
+#else
+    int      l_iexp;
+    uint32_t l_ulm, l_ulhi = 0;
+    
+    l_ulm = (uint32_t)ldexp(frexp(fabs(p_d), &l_iexp), 24);    // 2^23..2^24-1, 0 for 0.0
+    
+    if ( l_ulm )
+        l_ulhi = ((uint32_t)(l_iexp + 1022) << 20) | ((l_ulm >> 3) & 0xFFFFFUL);
+    
+    if ( p_d < 0.0 )
+        l_ulhi |= 0x80000000UL;
+    
+    fnrecput32(p_au, l_ulm << 29);
+    fnrecput32(&p_au[4], l_ulhi);
+#endif
+}
+
+
+// Sum of the bytes of a binary element record before the sum (mod 256)
+static uint8_t fnrecsum(const uint8_t *p_aurec) {
+    
+    size_t  l_ui;
+    uint8_t l_uisum = 0;
+    
+    for ( l_ui = 0; l_ui < g_scuiRECTAG + 3; l_ui++ )
+        l_uisum += p_aurec[l_ui];
+    
+    return (l_uisum);
+}
+
+
+// Get the elements and the name (P13_NAME_LEN + 1 characters) from a binary element
+// record in RAM. Returns P13_TLE_EFORMAT if it is no record of P13_REC_VERSION,
+// P13_TLE_ECHECKSUM if the sum does not match (elements not touched in both cases),
+// else P13_TLE_OK.
+static int recparse(P13Elements &p_el, char *p_acname, const uint8_t *p_aurec) {
+    
+    uint8_t l_ui;
+    size_t  l_uilen;
+    
+    if ( (p_aurec[g_scuiRECTAG] != 'P') || (p_aurec[g_scuiRECTAG + 1] != 'R') || (p_aurec[g_scuiRECTAG + 2] != P13_REC_VERSION) )
+        return (P13_TLE_EFORMAT);
+    
+    if ( p_aurec[g_scuiRECTAG + 3] != fnrecsum(p_aurec) )
+        return (P13_TLE_ECHECKSUM);
+    
+    for ( l_ui = 0; l_ui < g_scuiRECDBL; l_ui++ )
+        p_el.*g_scapdREC[l_ui] = fnrecgetd(&p_aurec[8 * l_ui]);
+    
+    p_el.c_lN  = (long)(int32_t)fnrecget32(&p_aurec[g_scuiRECINT]);
+    p_el.c_lYE = (long)(int32_t)fnrecget32(&p_aurec[g_scuiRECINT + 4]);
+    p_el.c_lDE = (long)(int32_t)fnrecget32(&p_aurec[g_scuiRECINT + 8]);
+    
+    for ( l_uilen = 0; (l_uilen < g_scuiRECNMLEN) && (l_uilen < P13_NAME_LEN) && p_aurec[g_scuiRECNAME + l_uilen]; l_uilen++ )
+        p_acname[l_uilen] = (char)p_aurec[g_scuiRECNAME + l_uilen];
+    
+    p_acname[l_uilen] = '\0';
+    
+    return (P13_TLE_OK);
+}
+
+
+// Writes the elements and the name (cut to 24 characters) as binary element record
+static void recwrite(uint8_t *p_aurec, const P13Elements &p_el, const char *p_ccnm) {
+    
+    uint8_t l_ui;
+    size_t  l_uilen = min(strlen(p_ccnm), g_scuiRECNMLEN);
+    
+    for ( l_ui = 0; l_ui < g_scuiRECDBL; l_ui++ )
+        fnrecputd(&p_aurec[8 * l_ui], p_el.*g_scapdREC[l_ui]);
+    
+    fnrecput32(&p_aurec[g_scuiRECINT],     (uint32_t)(int32_t)p_el.c_lN);
+    fnrecput32(&p_aurec[g_scuiRECINT + 4], (uint32_t)(int32_t)p_el.c_lYE);
+    fnrecput32(&p_aurec[g_scuiRECINT + 8], (uint32_t)(int32_t)p_el.c_lDE);
+    
+    memset(&p_aurec[g_scuiRECNAME], 0, g_scuiRECNMLEN);
+    memcpy(&p_aurec[g_scuiRECNAME], p_ccnm, l_uilen);
+    
+    p_aurec[g_scuiRECTAG]     = 'P';
+    p_aurec[g_scuiRECTAG + 1] = 'R';
+    p_aurec[g_scuiRECTAG + 2] = P13_REC_VERSION;
+    p_aurec[g_scuiRECTAG + 3] = fnrecsum(p_aurec);
+}
+
+
+// Solve M = EA - EC*SIN(EA) for EA given M, by Newton's Method, starting at EA.
+// Iterates until the change to EA is below tol. Returns the number of iterations,
+// cos/sin of the final EA and DNOM = 1 - EC*cos(EA).
+static int fnkepler(P13Real p_dM, P13Real p_dEC, P13Real p_dtol, P13Real &p_dEA, P13Real &p_dC_EA, P13Real &p_dS_EA, P13Real &p_dDNOM) {
+    
+    int     l_ii = 0;
+    P13Real l_dD, l_dC;
+    
+    do
+    {
+        p_dC_EA = cos(p_dEA);
+        p_dS_EA = sin(p_dEA);
+        p_dDNOM = (P13Real)1.0 - p_dEC * p_dC_EA;
+        l_dD    = (p_dEA - p_dEC * p_dS_EA - p_dM) / p_dDNOM;  // Change to EA for better solution
+        p_dEA  -= l_dD;                                        // by this amount
+        l_ii++;
+    }
+    while ( (fabs(l_dD) > p_dtol) && (l_ii < 32) );
+    
+    // cos/sin belong to EA before the last change, rotate them by -D (small angle)
+    l_dC    = p_dC_EA;
+    p_dC_EA = p_dC_EA + l_dD * p_dS_EA;
+    p_dS_EA = p_dS_EA - l_dD * l_dC;
+    p_dDNOM = (P13Real)1.0 - p_dEC * p_dC_EA;
+    
+    return (l_ii);
+}
+
+
+// Initial solution of Kepler's equation for M in range 0..2PI. EA = M converges fast
+// for near circular orbits; for high eccentricities the start value of Danby
+// (EA = M + 0.85*EC*sign(sin(M))) saves several iterations.
+static P13Real fnkepler0(P13Real p_dM, P13Real p_dEC) {
+    
+    if ( p_dEC < (P13Real)0.2 )
+        return (p_dM);
+    
+    return ((p_dM < (P13Real)PI) ? (p_dM + (P13Real)0.85 * p_dEC) : (p_dM - (P13Real)0.85 * p_dEC));
+}
+
+
+// Rotate the angle with cos/sin C/S by the angle with cos/sin CD/SD (angle addition)
+static inline void fnrotate(double &p_dC, double &p_dS, double p_dCD, double p_dSD) {
+    
+    double l_dC = p_dC;
+    
+    p_dC = l_dC * p_dCD - p_dS * p_dSD;
+    p_dS = p_dS * p_dCD + l_dC * p_dSD;
+}
+
+
+// Terms of the elapsed time T (days) since epoch of the elements drag DC, mean anomaly MA,
+// mean motion MM, argument of perigee WP, RAAN RA (and their rates WD, QD) for GHA of
+// Aries at epoch GHAE: drag term KD, mean anomaly M (0..2PI), argument of perigee AP,
+// RAAN and GHA Aries GHAA (0..2PI). The terms growing with T are calculated in double,
+// see P13Real. Shared by P13Satellite and P13Catalog, so both give the same results.
+static inline void fnelapsed(double p_dT, double p_dGHAE, double p_dDC, double p_dMA, double p_dMM, P13Real p_dWP, P13Real p_dWD, P13Real p_dRA, P13Real p_dQD, P13Real &p_dKD, double &p_dM, P13Real &p_dAP, P13Real &p_dRAAN, double &p_dGHAA) {
+    
+    double  l_dDT, l_dDR;
+    P13Real l_dKDP;
+    
+    l_dDT  = p_dDC * p_dT / 2.0;                             // Linear drag terms
+    p_dKD  = 1.0 + 4.0 * l_dDT;                              // -"-
+    l_dKDP = 1.0 - 7.0 * l_dDT;                              // -"-
+  
+    p_dM   = p_dMA + p_dMM * p_dT * (1.0 - 3.0 * l_dDT);     // Mean anomaly at YR,TN
+    l_dDR  = (long)(p_dM / (2.0 * PI));                      // Strip out whole no of revs
+    p_dM  -= l_dDR * 2.0 * PI;                               // M now in range 0..2PI
+    
+    p_dAP   = p_dWP + p_dWD * p_dT * l_dKDP;                 // Argument of perigee at T
+    p_dRAAN = p_dRA + p_dQD * p_dT * l_dKDP;                 // RAAN at T
+    p_dGHAA = p_dGHAE + g_scdWE * p_dT;                      // GHA Aries at elapsed time T
+    p_dGHAA -= (long)(p_dGHAA / (2.0 * PI)) * 2.0 * PI;      // Strip out whole no of revs for P13Real
+}
+
+
+// Calculates the state vectors from the semi axes A_0/B_0, eccentricity EC and mean
+// motion N0 of the elements, the solution of Kepler's equation (cos/sin of EA,
+// DNOM = 1 - EC*cos(EA)), the drag term KD and cos/sin of argument of perigee (W),
+// RAAN (Q), inclination (I) and -GHA Aries (G) into state st, see fnelapsed().
+static inline void fnstate(P13State &p_st, P13Real p_dA_0, P13Real p_dB_0, P13Real p_dEC, P13Real p_dN0, P13Real p_dKD, P13Real p_dC_EA, P13Real p_dS_EA, P13Real p_dDNOM, P13Real p_dCW, P13Real p_dSW, P13Real p_dCQ, P13Real p_dSQ, P13Real p_dCI, P13Real p_dSI, P13Real p_dCG, P13Real p_dSG) {
+    
+    P13Real l_dA, l_dB;
+    
+    Vec3 l_vecCX, l_vecCY, l_vecCZ;
+    
+    // Distances
+    l_dA = p_dA_0 * p_dKD;           
+    l_dB = p_dB_0 * p_dKD;
+    p_st.c_dRS = l_dA * p_dDNOM;
+
+    // Calc satellite position & velocity in plane of ellipse
+    p_st.c_vecS[0] = l_dA * (p_dC_EA - p_dEC);
+    p_st.c_vecS[1] = l_dB * p_dS_EA;
+    
+    p_st.c_vecV[0] = -l_dA * p_dS_EA / p_dDNOM * p_dN0;
+    p_st.c_vecV[1] =  l_dB * p_dC_EA / p_dDNOM * p_dN0;
+
+    // CX, CY, and CZ form a 3x3 matrix that converts between orbit
+    // coordinates, and celestial coordinates.
+    
+    // Plane -> celestial coordinate transformation, [C] = [RAAN]*[IN]*[AP]
+    l_vecCX[0] =  p_dCW * p_dCQ - p_dSW * p_dCI * p_dSQ;
+    l_vecCX[1] = -p_dSW * p_dCQ - p_dCW * p_dCI * p_dSQ;
+    l_vecCX[2] =  p_dSI * p_dSQ;
+
+    l_vecCY[0] =  p_dCW * p_dSQ + p_dSW * p_dCI * p_dCQ;
+    l_vecCY[1] = -p_dSW * p_dSQ + p_dCW * p_dCI * p_dCQ;
+    l_vecCY[2] = -p_dSI * p_dCQ;
+
+    l_vecCZ[0] = p_dSW * p_dSI;
+    l_vecCZ[1] = p_dCW * p_dSI;
+    l_vecCZ[2] = p_dCI;
+
+    // Compute SATellite's position vector and VELocity in
+    // CELESTIAL coordinates. (Note: Sz=S[2]=0, Vz=V[2]=0)
+    p_st.c_vecSAT[0] = p_st.c_vecS[0] * l_vecCX[0] + p_st.c_vecS[1] * l_vecCX[1];
+    p_st.c_vecSAT[1] = p_st.c_vecS[0] * l_vecCY[0] + p_st.c_vecS[1] * l_vecCY[1];
+    p_st.c_vecSAT[2] = p_st.c_vecS[0] * l_vecCZ[0] + p_st.c_vecS[1] * l_vecCZ[1];
+
+    p_st.c_vecVEL[0] = p_st.c_vecV[0] * l_vecCX[0] + p_st.c_vecV[1] * l_vecCX[1];
+    p_st.c_vecVEL[1] = p_st.c_vecV[0] * l_vecCY[0] + p_st.c_vecV[1] * l_vecCY[1];
+    p_st.c_vecVEL[2] = p_st.c_vecV[0] * l_vecCZ[0] + p_st.c_vecV[1] * l_vecCZ[1];
+
+    // Also express SAT and VEL in GEOCENTRIC coordinates:
+    p_st.c_vecS[0] = p_st.c_vecSAT[0] * p_dCG - p_st.c_vecSAT[1] * p_dSG;
+    p_st.c_vecS[1] = p_st.c_vecSAT[0] * p_dSG + p_st.c_vecSAT[1] * p_dCG;
+    p_st.c_vecS[2] = p_st.c_vecSAT[2];
+
+    p_st.c_vecV[0] = p_st.c_vecVEL[0] * p_dCG - p_st.c_vecVEL[1]* p_dSG;
+    p_st.c_vecV[1] = p_st.c_vecVEL[0] * p_dSG + p_st.c_vecVEL[1]* p_dCG;
+    p_st.c_vecV[2] = p_st.c_vecVEL[2];
+    
+    p_st.c_dCG = p_dCG;
+    p_st.c_dSG = p_dSG;
+}
+
+
+// Greenwich apparent sidereal time (J. Meeus, Astronomical Algorithms, ch. 12), rad, for
+// D + F days since J2000.0 (whole days D, fraction F), T in Julian centuries and the
+// nutation in right ascension nut (deg). The whole days only add 0.98564736629 deg each.
+static double fngast(long p_lD, double p_dF, double p_dT, double p_dnut) {
+    
+    return (radians(fmod(280.46061837 + 360.0 * p_dF + fmod(0.98564736629 * (double)p_lD, 360.0)
+                         + 0.98564736629 * p_dF + 0.000387933 * p_dT * p_dT
+                         + p_dnut, 360.0)));
+}
+
+
+// Elevation, azimuth (deg), range (km) and range rate (km/s) of the geocentric position S
+// and velocity V of a satellite for an observer
+static void fnlook(const Vec3 p_vecS, const Vec3 p_vecV, const P13Observer &p_obs, P13Look &p_look) {
+    
+    P13Real l_dr, l_du, l_de, l_dn;
+    double  l_daz;
+    
+    Vec3 l_vecR; // Rangevec
+    
+    // Rangevec = Satvec - Obsvec
+    l_vecR[0] = p_vecS[0] - p_obs.c_vecO[0];
+    l_vecR[1] = p_vecS[1] - p_obs.c_vecO[1];
+    l_vecR[2] = p_vecS[2] - p_obs.c_vecO[2];
+    
+    // Range magnitude
+    l_dr = sqrt(l_vecR[0] * l_vecR[0] + l_vecR[1] * l_vecR[1] + l_vecR[2] * l_vecR[2]);
+    
+    // Normalise Range vector
+    l_vecR[0] /= l_dr;
+    l_vecR[1] /= l_dr;
+    l_vecR[2] /= l_dr;
+    
+    // UP Component of unit range
+    l_du = l_vecR[0] * p_obs.c_vecU[0] + l_vecR[1] * p_obs.c_vecU[1] + l_vecR[2] * p_obs.c_vecU[2];
+    // EAST
+    l_de = l_vecR[0] * p_obs.c_vecE[0] + l_vecR[1] * p_obs.c_vecE[1];
+    //NORTH
+    l_dn = l_vecR[0] * p_obs.c_vecN[0] + l_vecR[1] * p_obs.c_vecN[1] + l_vecR[2] * p_obs.c_vecN[2];
+    
+    // Azimuth
+    l_daz = degrees(atan2(l_de, l_dn));
+    
+    if (l_daz < 0.0)
+        l_daz += 360.0;
+    
+    p_look.c_dAZ    = l_daz;
+    
+    // Elevation
+    p_look.c_dEL    = degrees(asin(l_du));
+    p_look.c_dRange = l_dr;
+    
+    // Resolve Sat-Obs velocity vector along unit range vector. (VOz=obs.V[2]=0)
+    p_look.c_dRR    = (p_vecV[0] - p_obs.c_vecV[0]) * l_vecR[0] + (p_vecV[1] - p_obs.c_vecV[1]) * l_vecR[1] + p_vecV[2] * l_vecR[2];    // Range rate, km/s
+}
+
+
+// Coarse visibility test of a satellite for the window of w days. The sub satellite
+// point is in the orbit plane, so the satellite can only be above minel (deg) while
+// the angular distance of the observer from the plane is below the radius of the
+// visibility circle at apogee radius RA (km). The sine of this distance is
+// SLA*CI + CLA*SI*sin(h) with the geocentric latitude of the observer (SLA/CLA, sin/cos)
+// and the inclination (CI/SI, cos/sin), h = RAAN - GHA Aries - longitude of the
+// observer changes from h at the start with the rate hd (rad/day). For orbits with
+// EC <= 0.3 the satellite has also to come close to the observer along the orbit: its
+// argument of latitude (mean value u at the start, rate ud in rad/day, the true value
+// differs by less than 2.5*EC) has to pass the one of the observer within the radius
+// of the visibility circle plus the motion of the observer within the window. The
+// argument of latitude uo of the observer (of its projection onto the plane) changes
+// with dh by duo = CLA * (SLA*SI*sin(h) - CLA*CI) / (1 - z^2) * dh, z the sine of the
+// distance from the plane, so the motion is bounded with the largest z in the window.
+// Returns false if the satellite certainly stays below minel within the window.
+static bool fnreach(double p_dRA, double p_dEC, double p_dCI, double p_dSI, double p_dh, double p_dhd, double p_du, double p_dud, double p_dSLA, double p_dCLA, double p_dminel, double p_dw) {
+    
+    double l_dmine, l_dc, l_dlam, l_dh0, l_dh1, l_dsmin, l_dsmax, l_dsl, l_da, l_db;
+    double l_dz, l_dlamw, l_dspan, l_duo;
+    
+    l_dmine = radians(p_dminel);
+    l_dc    = g_scdRE * cos(l_dmine) / p_dRA;
+    
+    if ( l_dc >= 1.0 )
+        return (false);
+    
+    l_dlam = acos(l_dc) - l_dmine + radians(1.0);   // Visibility circle radius, 1 deg margin (observer height, drag)
+    
+    if ( l_dlam >= PI / 2.0 )
+        return (true);
+    
+    // Range of sin(h) within the window
+    l_dh0 = min(p_dh, p_dh + p_dhd * p_dw);
+    l_dh1 = max(p_dh, p_dh + p_dhd * p_dw);
+    
+    if ( l_dh1 - l_dh0 >= 2.0 * PI )
+    {
+        l_dsmin = -1.0;
+        l_dsmax =  1.0;
+    }
+    else
+    {
+        l_dsmin = min(sin(l_dh0), sin(l_dh1));
+        l_dsmax = max(sin(l_dh0), sin(l_dh1));
+        
+        if ( PI / 2.0 + 2.0 * PI * ceil((l_dh0 - PI / 2.0) / (2.0 * PI)) <= l_dh1 )
+            l_dsmax = 1.0;
+        
+        if ( -PI / 2.0 + 2.0 * PI * ceil((l_dh0 + PI / 2.0) / (2.0 * PI)) <= l_dh1 )
+            l_dsmin = -1.0;
+    }
+    
+    l_dsl = sin(l_dlam);
+    l_da  = p_dSLA * p_dCI;
+    l_db  = p_dCLA * p_dSI;
+    
+    if ( (l_da + l_db * l_dsmin > l_dsl) || (l_da + l_db * l_dsmax < -l_dsl) )
+        return (false);
+    
+    if ( p_dEC > 0.3 )
+        return (true);
+    
+    // Largest distance of the observer from the plane (sine) within the window
+    l_dz = max(fabs(l_da + l_db * l_dsmin), fabs(l_da + l_db * l_dsmax));
+    
+    if ( l_dz >= 0.999 )
+        return (true);
+    
+    // Span of the argument of latitude of the satellite around the one of the observer
+    // at the start (in the plane with the ascending node as x axis)
+    l_dlamw = l_dlam + p_dCLA * (fabs(p_dSLA) * p_dSI + p_dCLA * fabs(p_dCI)) / (1.0 - l_dz * l_dz) * fabs(p_dhd) * p_dw;
+    l_dspan = fabs(p_dud) * p_dw + 5.0 * p_dEC + 2.0 * l_dlamw;
+    
+    if ( l_dspan >= 2.0 * PI )
+        return (true);
+    
+    l_duo = atan2(-p_dCLA * sin(p_dh) * p_dCI + p_dSLA * p_dSI, p_dCLA * cos(p_dh));
+    l_duo = fmod(l_duo - (p_dud >= 0.0 ? p_du : p_du + p_dud * p_dw) + 2.5 * p_dEC + l_dlamw, 2.0 * PI);
+    
+    if ( l_duo < 0.0 )
+        l_duo += 2.0 * PI;
+    
+    return (l_duo <= l_dspan);
+}
+
+
+// Geocentric latitude (sin/cos) and longitude (rad) of an observer for fnreach()
+static void fnreachobs(const P13Observer &p_obs, double &p_dSLA, double &p_dCLA, double &p_dLO) {
+    
+    double l_dro, l_drxy;
+    
+    l_drxy = sqrt(p_obs.c_vecO[0] * p_obs.c_vecO[0] + p_obs.c_vecO[1] * p_obs.c_vecO[1]);
+    l_dro  = sqrt(l_drxy * l_drxy + p_obs.c_vecO[2] * p_obs.c_vecO[2]);
+    
+    p_dSLA = p_obs.c_vecO[2] / l_dro;
+    p_dCLA = l_drxy / l_dro;
+    p_dLO  = atan2(p_obs.c_vecO[1], p_obs.c_vecO[0]);
+}
+
+
+// Azimuth and elevation (deg) of the antenna for the look angles az/el in a rotator mode
+// (P13_ROT_...). In P13_ROT_OVERHEAD the antenna stays at the azimuth plane of the pass
+// and the elevation is the angle within the vertical plane through it.
+static void fnrotmap(uint8_t p_uimode, double p_dplane, double &p_daz, double &p_del) {
+    
+    double l_dh;
+    
+    if ( p_uimode == P13_ROT_FLIP )
+    {
+        p_daz = (p_daz < 180.0) ? p_daz + 180.0 : p_daz - 180.0;
+        p_del = 180.0 - p_del;
+    }
+    else if ( p_uimode == P13_ROT_OVERHEAD )
+    {
+        l_dh  = cos(radians(p_del)) * cos(radians(p_daz - p_dplane));
+        p_daz = p_dplane;
+        p_del = degrees(atan2(sin(radians(p_del)), l_dh));
+        
+        if ( p_del < -90.0 )
+            p_del += 360.0;     // Below the horizon behind the zenith
+    }
+}
+
+
+// Difference of two azimuths reduced to -180..180 deg
+static double fnrotwrap(double p_dd) {
+    
+    if ( p_dd >  180.0 ) p_dd -= 360.0;
+    if ( p_dd < -180.0 ) p_dd += 360.0;
+    
+    return (p_dd);
+}
+
+
+// Turns the azimuth az by whole turns into min..max (deg) if it is out of the range and
+// the range allows it, else it is limited to the range
+static double fnrotrange(double p_daz, double p_dmin, double p_dmax) {
+    
+    if ( p_daz > p_dmax )
+        p_daz -= 360.0 * ceil((p_daz - p_dmax) / 360.0);
+    
+    if ( p_daz < p_dmin )
+        p_daz += 360.0 * ceil((p_dmin - p_daz) / 360.0);
+    
+    return (constrain(p_daz, p_dmin, p_dmax));
+}
+
+
+// Moves from prev towards target by at most lim (lim <= 0: no limit)
+static double fnrotslew(double p_dprev, double p_dtarget, double p_dlim) {
+    
+    if ( p_dlim <= 0.0 )
+        return (p_dtarget);
+    
+    return (constrain(p_dtarget, p_dprev - p_dlim, p_dprev + p_dlim));
+}
+
+
+// Converts latitude (Breitengrad) -90..90° / longitude (Laengengrad) -180..180°
+// to x/y-coordinates of a map with maxamimum dimension MapMaxX * MapMaxY
+void latlon2xy(int &p_ix, int &p_iy, double p_dlat, double p_dlon, const int p_ciMapMaxX, const int p_ciMapMaxY) {
+    
+    p_ix = (int)((((180.0 + p_dlon) / 360.0) * (double)p_ciMapMaxX));
+    p_iy = (int)(((( 90.0 - p_dlat) / 180.0) * (double)p_ciMapMaxY));
+    
+}
+
+
+//----------------------------------------------------------------------
+//     _              ___  _ _______       _      _____ _           
+//  __| |__ _ ______ | _ \/ |__ /   \ __ _| |_ __|_   _(_)_ __  ___ 
+// / _| / _` (_-<_-< |  _/| ||_ \ |) / _` |  _/ -_)| | | | '  \/ -_)
+// \__|_\__,_/__/__/ |_|  |_|___/___/\__,_|\__\___||_| |_|_|_|_\___|
+//                                                       
+//----------------------------------------------------------------------
+
+P13DateTime::P13DateTime() {
+    
+   c_lDN = 0L;
+   c_dTN = 0.0;
+}
+
+
+P13DateTime::P13DateTime(const P13DateTime &p_dt) {
+    
+    c_lDN = p_dt.c_lDN;
+    c_dTN = p_dt.c_dTN;
+}
+
+
+P13DateTime::P13DateTime(int p_iyear, int p_imonth, int p_iday, int p_ih, int p_im, int p_is) {
+
+    settime(p_iyear, p_imonth, p_iday, p_ih, p_im, p_is);
+}
+
+
+P13DateTime::~P13DateTime() {
+    
+}
+
+
+P13DateTime &P13DateTime::operator=(const P13DateTime &p_dt) {
+    
+    c_lDN = p_dt.c_lDN;
+    c_dTN = p_dt.c_dTN;
+    
+    return (*this);
+}
+
+
+void P13DateTime::add(double p_ddays) {
+    
+    c_dTN += p_ddays;
+    c_lDN += (long)c_dTN;
+    c_dTN -= (long)c_dTN;
+    
+    if ( c_dTN < 0.0 )  // Keep TN in 0..1 when going back in time
+    {
+        c_dTN += 1.0;
+        c_lDN--;
+    }
+}
+
+
+void P13DateTime::settime(int p_iyear, int p_imonth, int p_iday, int p_ih, int p_im, int p_is) {
+    
+    c_lDN = fnday(p_iyear, p_imonth, p_iday);
+    c_dTN = ((double)p_ih + (double)p_im / 60.0 + (double)p_is / 3600.0) / 24.0;
+}
+
+
+// Sets the time to base + ms milliseconds, e.g. with base the time of the last NTP/GPS
+// sync and ms = millis() - millis() at the sync (correct across the wrap of millis()).
+// The milliseconds are split into days and time of day in integer, so the time does not
+// drift with growing offsets.
+void P13DateTime::settime(const P13DateTime &p_dtbase, uint32_t p_ulms) {
+    
+    c_lDN = p_dtbase.c_lDN + (long)(p_ulms / 86400000UL);
+    c_dTN = p_dtbase.c_dTN + (double)(p_ulms % 86400000UL) / 86400000.0;
+    
+    if ( c_dTN >= 1.0 )
+    {
+        c_dTN -= 1.0;
+        c_lDN++;
+    }
+}
+
+
+// Sets the time from Unix time (seconds since 1970 Jan 01 00:00:00 UTC, as from NTP, GPS
+// or an RTC) plus fraction of a second 0..1
+void P13DateTime::setunix(uint32_t p_ulsec, double p_dfrac) {
+    
+    c_lDN = g_sclUNIX + (long)(p_ulsec / 86400UL);
+    c_dTN = ((double)(p_ulsec % 86400UL) + p_dfrac) / 86400.0;
+}
+
+
+void P13DateTime::gettime(int &p_iyear, int &p_imonth, int &p_iday, int &p_ih, int &p_im, int &p_is) {
+    
+    long l_ldn, l_lsec;
+    
+    l_ldn  = c_lDN;
+    l_lsec = fnsecofday(c_dTN);
+    
+    if ( l_lsec >= 86400L )
+    {
+        l_lsec -= 86400L;
+        l_ldn++;
+    }
+    
+    fndate(p_iyear, p_imonth, p_iday, l_ldn);
+    p_ih = (int)(l_lsec / 3600L);
+    p_im = (int)((l_lsec / 60L) % 60L);
+    p_is = (int)(l_lsec % 60L);
+}
+
+
+// Returns the time as Unix time (seconds since 1970 Jan 01 00:00:00 UTC), valid up to 2100
+uint32_t P13DateTime::getunix() {
+    
+    return ((uint32_t)(c_lDN - g_sclUNIX) * 86400UL + (uint32_t)fnsecofday(c_dTN));
+}
+
+
+// Writes the time as "YYYY-MM-DD hh:mm:ss" (ascii_str_len characters plus '\0')
+// without sprintf
+void P13DateTime::ascii(char *p_cbuf) {
+    
+    int l_iyear, l_imon, l_iday;
+    int l_ih, l_im, l_is;
+    
+    gettime(l_iyear, l_imon, l_iday, l_ih, l_im, l_is);
+    // 2019-05-11 00:53:13
+    p_cbuf = fndigits(p_cbuf, l_iyear, 4);
+    *p_cbuf++ = '-';
+    p_cbuf = fndigits(p_cbuf, l_imon, 2);
+    *p_cbuf++ = '-';
+    p_cbuf = fndigits(p_cbuf, l_iday, 2);
+    *p_cbuf++ = ' ';
+    p_cbuf = fndigits(p_cbuf, l_ih, 2);
+    *p_cbuf++ = ':';
+    p_cbuf = fndigits(p_cbuf, l_im, 2);
+    *p_cbuf++ = ':';
+    p_cbuf = fndigits(p_cbuf, l_is, 2);
+    *p_cbuf   = '\0';
+}
+
+
+void P13DateTime::roundup(double p_dtime) {
+    
+    double l_dinc;
+    
+    l_dinc = p_dtime - fmod(c_dTN, p_dtime);
+    
+    c_dTN += l_dinc;
+    c_lDN += (long)c_dTN;
+    c_dTN -= (long)c_dTN;
+}
+
+
+//----------------------------------------------------------------------
+//     _              ___  _ ____ ___  _                            
+//  __| |__ _ ______ | _ \/ |__ // _ \| |__ ___ ___ _ ___ _____ _ _ 
+// / _| / _` (_-<_-< |  _/| ||_ \ (_) | '_ (_-</ -_) '_\ V / -_) '_|
+// \__|_\__,_/__/__/ |_|  |_|___/\___/|_.__/__/\___|_|  \_/\___|_|  
+//                                                      
+//----------------------------------------------------------------------
+
+// Set the observers parameters from latitude, longitude and altitude
+// above sea level (m).
+P13Observer::P13Observer(const char *p_ccnm, double p_dlat, double p_dlon, double p_dasl) {
+    
+    double l_dD, l_dCL, l_dSL, l_dCO, l_dSO;
+    double l_dRx;
+    double l_dRz;
+    
+#ifndef P13_NAME_INLINE
+    c_ccObsName = nullptr;
+#endif
+    fnname(c_ccObsName, p_ccnm);
+
+    c_dLA = radians(p_dlat);
+    c_dLO = radians(p_dlon);
+    c_dHT = p_dasl / 1000.0;
+
+    l_dCL = cos(c_dLA);
+    l_dSL = sin(c_dLA);
+    l_dCO = cos(c_dLO);
+    l_dSO = sin(c_dLO);
+
+    c_vecU[0] = l_dCL * l_dCO;
+    c_vecU[1] = l_dCL * l_dSO;
+    c_vecU[2] = l_dSL;
+
+    c_vecE[0] = -l_dSO;
+    c_vecE[1] =  l_dCO;
+    c_vecE[2] =  0.0;
+
+    c_vecN[0] = -l_dSL * l_dCO;
+    c_vecN[1] = -l_dSL * l_dSO;
+    c_vecN[2] =  l_dCL;
+
+    l_dD = sqrt(g_scdRE * g_scdRE * l_dCL * l_dCL + g_scdRP * g_scdRP * l_dSL * l_dSL);
+    l_dRx = (g_scdRE * g_scdRE) / l_dD + c_dHT;
+    l_dRz = (g_scdRP * g_scdRP) / l_dD + c_dHT;
+
+    c_vecO[0] = l_dRx * c_vecU[0];
+    c_vecO[1] = l_dRx * c_vecU[1];
+    c_vecO[2] = l_dRz * c_vecU[2];
+
+    c_vecV[0] = -c_vecO[1] * g_scdW0;
+    c_vecV[1] =  c_vecO[0] * g_scdW0;
+    c_vecV[2] =  0.0;
+
+}
+
+
+P13Observer::P13Observer(const P13Observer &p_obs) {
+    
+#ifndef P13_NAME_INLINE
+    c_ccObsName = nullptr;
+#endif
+    fnname(c_ccObsName, p_obs.c_ccObsName);
+    copy(p_obs);
+}
+
+
+P13Observer::~P13Observer() {
+#ifndef P13_NAME_INLINE
+    fnnamefree(c_ccObsName);
+#endif
+}
+
+
+P13Observer &P13Observer::operator=(const P13Observer &p_obs) {
+    
+    if ( this != &p_obs )
+    {
+        fnname(c_ccObsName, p_obs.c_ccObsName);
+        copy(p_obs);
+    }
+    
+    return (*this);
+}
+
+
+#ifndef P13_NAME_INLINE
+// Takes over the name buffer of obs, which is left with an empty name
+P13Observer::P13Observer(P13Observer &&p_obs) {
+    
+    c_ccObsName = p_obs.c_ccObsName;
+    p_obs.c_ccObsName = g_sacNoName;
+    copy(p_obs);
+}
+
+
+// Swaps the name buffers, so obs keeps a valid name
+P13Observer &P13Observer::operator=(P13Observer &&p_obs) {
+    
+    char *l_pcname;
+    
+    if ( this != &p_obs )
+    {
+        l_pcname = c_ccObsName;
+        c_ccObsName = p_obs.c_ccObsName;
+        p_obs.c_ccObsName = l_pcname;
+        copy(p_obs);
+    }
+    
+    return (*this);
+}
+#endif
+
+
+// Copies everything but the name
+void P13Observer::copy(const P13Observer &p_obs) {
+    
+    c_dLA = p_obs.c_dLA;
+    c_dLO = p_obs.c_dLO;
+    c_dHT = p_obs.c_dHT;
+    
+    memcpy(c_vecU, p_obs.c_vecU, sizeof(Vec3));
+    memcpy(c_vecE, p_obs.c_vecE, sizeof(Vec3));
+    memcpy(c_vecN, p_obs.c_vecN, sizeof(Vec3));
+    memcpy(c_vecO, p_obs.c_vecO, sizeof(Vec3));
+    memcpy(c_vecV, p_obs.c_vecV, sizeof(Vec3));
+}
+
+//----------------------------------------------------------------------
+//     _              ___  _ _______       _       _ _ _ _       
+//  __| |__ _ ______ | _ \/ |__ / __| __ _| |_ ___| | (_) |_ ___ 
+// / _| / _` (_-<_-< |  _/| ||_ \__ \/ _` |  _/ -_) | | |  _/ -_)
+// \__|_\__,_/__/__/ |_|  |_|___/___/\__,_|\__\___|_|_|_|\__\___|
+//
+//----------------------------------------------------------------------
+
+// Satellite from a TLE, see tle(). If the TLE is not valid the satellite gets the name
+// and zero elements, so it is defined but predict() gives no meaningful position.
+P13Satellite::P13Satellite(const char *p_ccnm, const char *p_ccl1, const char *p_ccl2) {
+#ifndef P13_NAME_INLINE
+    c_ccSatName = nullptr;
+#endif
+    
+    clear();
+    
+    if ( tle(p_ccnm, p_ccl1, p_ccl2) == P13_TLE_EFORMAT )
+        fnname(c_ccSatName, p_ccnm);
+}
+
+
+// Satellite from a binary element record, see load(). If the record is not valid the
+// name is empty and the elements are zero, as for a TLE that is not valid.
+P13Satellite::P13Satellite(const uint8_t *p_aurec, bool p_bprogmem) {
+#ifndef P13_NAME_INLINE
+    c_ccSatName = nullptr;
+#endif
+    
+    clear();
+    load(p_aurec, p_bprogmem);
+}
+
+P13Satellite::P13Satellite(const P13Satellite &p_sat) {
+    
+#ifndef P13_NAME_INLINE
+    c_ccSatName = nullptr;
+#endif
+    fnname(c_ccSatName, p_sat.c_ccSatName);
+    copy(p_sat);
+}
+
+P13Satellite::~P13Satellite() {
+#ifndef P13_NAME_INLINE
+    fnnamefree(c_ccSatName);
+#endif
+}
+
+
+P13Satellite &P13Satellite::operator=(const P13Satellite &p_sat) {
+    
+    if ( this != &p_sat )
+    {
+        fnname(c_ccSatName, p_sat.c_ccSatName);
+        copy(p_sat);
+    }
+    
+    return (*this);
+}
+
+
+#ifndef P13_NAME_INLINE
+// Takes over the name buffer of sat, which is left with an empty name
+P13Satellite::P13Satellite(P13Satellite &&p_sat) {
+    
+    c_ccSatName = p_sat.c_ccSatName;
+    p_sat.c_ccSatName = g_sacNoName;
+    copy(p_sat);
+}
+
+
+// Swaps the name buffers, so sat keeps a valid name
+P13Satellite &P13Satellite::operator=(P13Satellite &&p_sat) {
+    
+    char *l_pcname;
+    
+    if ( this != &p_sat )
+    {
+        l_pcname = c_ccSatName;
+        c_ccSatName = p_sat.c_ccSatName;
+        p_sat.c_ccSatName = l_pcname;
+        copy(p_sat);
+    }
+    
+    return (*this);
+}
+#endif
+
+
+// Copies elements and state, everything but the name
+void P13Satellite::copy(const P13Satellite &p_sat) {
+    
+    c_ulKeplerCalls = p_sat.c_ulKeplerCalls;
+    c_ulKeplerIter  = p_sat.c_ulKeplerIter;
+    
+    memcpy(c_vecSAT, p_sat.c_vecSAT, sizeof(Vec3));
+    memcpy(c_vecVEL, p_sat.c_vecVEL, sizeof(Vec3));
+    memcpy(c_vecS,   p_sat.c_vecS,   sizeof(Vec3));
+    memcpy(c_vecV,   p_sat.c_vecV,   sizeof(Vec3));
+    
+    cp_lN   = p_sat.cp_lN;
+    cp_lYE  = p_sat.cp_lYE;
+    cp_dTE  = p_sat.cp_dTE;
+    cp_dIN  = p_sat.cp_dIN;
+    cp_dRA  = p_sat.cp_dRA;
+    cp_dEC  = p_sat.cp_dEC;
+    cp_dWP  = p_sat.cp_dWP;
+    cp_dMA  = p_sat.cp_dMA;
+    cp_dMM  = p_sat.cp_dMM;
+    cp_dM2  = p_sat.cp_dM2;
+    cp_dRV  = p_sat.cp_dRV;
+    cp_lDE  = p_sat.cp_lDE;
+    
+    cp_dN0  = p_sat.cp_dN0;
+    cp_dA_0 = p_sat.cp_dA_0;
+    cp_dB_0 = p_sat.cp_dB_0;
+    cp_dPC  = p_sat.cp_dPC;
+    cp_dQD  = p_sat.cp_dQD;
+    cp_dWD  = p_sat.cp_dWD;
+    cp_dDC  = p_sat.cp_dDC;
+#ifndef P13_LEAN
+    cp_dGHAE = p_sat.cp_dGHAE;
+    cp_dCI   = p_sat.cp_dCI;
+    cp_dSI   = p_sat.cp_dSI;
+#endif
+    
+    cp_dRS  = p_sat.cp_dRS;
+    cp_dRR  = p_sat.cp_dRR;
+    cp_dCG  = p_sat.cp_dCG;
+    cp_dSG  = p_sat.cp_dSG;
+    
+    cp_bWarm     = p_sat.cp_bWarm;
+    cp_bEA       = p_sat.cp_bEA;
+    cp_dKTol     = p_sat.cp_dKTol;
+    cp_dMprev    = p_sat.cp_dMprev;
+    cp_dEAprev   = p_sat.cp_dEAprev;
+    cp_dDNOMprev = p_sat.cp_dDNOMprev;
+    
+    cp_uiEngine  = p_sat.cp_uiEngine;
+#ifdef P13_SGP4
+    cp_sgp4      = p_sat.cp_sgp4;
+#endif
+}
+
+
+// Sets a defined state for the constructors: empty name, zero elements and state,
+// Plan13 without warm start
+void P13Satellite::clear() {
+    
+    P13Elements l_el;
+    
+    memset(&l_el, 0, sizeof(l_el));
+    
+    fnname(c_ccSatName, "");
+    
+    c_ulKeplerCalls = 0;
+    c_ulKeplerIter  = 0;
+    cp_bWarm        = false;
+    cp_dKTol        = 1.0E-5;
+    cp_uiEngine     = P13_ENG_PLAN13;
+    
+    memset(c_vecSAT, 0, sizeof(Vec3));
+    memset(c_vecVEL, 0, sizeof(Vec3));
+    memset(c_vecS,   0, sizeof(Vec3));
+    memset(c_vecV,   0, sizeof(Vec3));
+    
+    cp_dRS       = 0.0;
+    cp_dRR       = 0.0;
+    cp_dCG       = 1.0;
+    cp_dSG       = 0.0;
+    cp_dMprev    = 0.0;
+    cp_dEAprev   = 0.0;
+    cp_dDNOMprev = 1.0;
+    
+#ifdef P13_SGP4
+    memset(&cp_sgp4, 0, sizeof(cp_sgp4));
+#endif
+    
+    setElements(l_el);
+}
+
+// Get satellite data from the TLE. Returns P13_TLE_OK, P13_TLE_ECHECKSUM (elements are
+// used anyway) or P13_TLE_EFORMAT (elements and name are not changed).
+
+int P13Satellite::tle(const char *p_ccnm, const char *p_ccl1, const char *p_ccl2) {
+    
+    int         l_istat;
+    P13Elements l_el;
+    
+    l_istat = tleparse(l_el, p_ccl1, strlen(p_ccl1), p_ccl2, strlen(p_ccl2));
+    
+    if ( l_istat == P13_TLE_EFORMAT )
+        return (l_istat);
+    
+    fnname(c_ccSatName, p_ccnm);
+    setElements(l_el);
+    
+    return (l_istat);
+}
+
+
+// Get satellite data from a binary element record (see P13_REC_SIZE, e.g. from
+// extras/tle2bin) without parsing a TLE. A record in RAM, in memory mapped flash (ESP32)
+// or in a file mapped into memory is used directly, with progmem it is read from the
+// program memory (PROGMEM) of AVR or ESP8266. Returns P13_TLE_OK, P13_TLE_ECHECKSUM or
+// P13_TLE_EFORMAT (elements and name are not changed on errors).
+int P13Satellite::load(const uint8_t *p_aurec, bool p_bprogmem) {
+    
+    int         l_istat;
+    P13Elements l_el;
+    char        l_acname[P13_NAME_LEN + 1];
+    uint8_t     l_aurec[P13_REC_SIZE];
+    
+    if ( p_bprogmem )
+    {
+        memcpy_P(l_aurec, p_aurec, P13_REC_SIZE);
+        p_aurec = l_aurec;
+    }
+    
+    l_istat = recparse(l_el, l_acname, p_aurec);
+    
+    if ( l_istat != P13_TLE_OK )
+        return (l_istat);
+    
+    fnname(c_ccSatName, l_acname);
+    setElements(l_el);
+    
+    return (P13_TLE_OK);
+}
+
+
+// Writes the elements as binary element record with P13_REC_SIZE bytes
+void P13Satellite::save(uint8_t *p_aurec) const {
+    
+    P13Elements l_el;
+    
+    getElements(l_el);
+    recwrite(p_aurec, l_el, c_ccSatName);
+}
+
+
+// Sets the elements from tle() or load()
+void P13Satellite::setElements(const P13Elements &p_el) {
+    
+    cp_lN   = p_el.c_lN;
+    cp_lYE  = p_el.c_lYE;
+    cp_lDE  = p_el.c_lDE;
+    cp_dTE  = p_el.c_dTE;
+    cp_dIN  = p_el.c_dIN;
+    cp_dRA  = p_el.c_dRA;
+    cp_dEC  = p_el.c_dEC;
+    cp_dWP  = p_el.c_dWP;
+    cp_dMA  = p_el.c_dMA;
+    cp_dMM  = p_el.c_dMM;
+    cp_dM2  = p_el.c_dM2;
+    cp_dRV  = p_el.c_dRV;
+    
+    cp_dN0  = p_el.c_dN0;
+    cp_dA_0 = p_el.c_dA_0;
+    cp_dB_0 = p_el.c_dB_0;
+    cp_dPC  = p_el.c_dPC;
+    cp_dQD  = p_el.c_dQD;
+    cp_dWD  = p_el.c_dWD;
+    cp_dDC  = p_el.c_dDC;
+    cp_bEA  = false;     // No warm start across different elements
+#ifndef P13_LEAN
+    cp_dGHAE = p_el.c_dGHAE;
+    cp_dCI   = p_el.c_dCI;
+    cp_dSI   = p_el.c_dSI;
+#endif
+    
+#ifdef P13_SGP4
+    cp_sgp4.c_dBS = p_el.c_dBS;
+    cp_sgp4.c_dEC = p_el.c_dEC;
+    cp_sgp4.c_dIN = p_el.c_dIN;
+    cp_sgp4.c_dRA = p_el.c_dRA;
+    cp_sgp4.c_dWP = p_el.c_dWP;
+    cp_sgp4.c_dMA = p_el.c_dMA;
+    
+    if ( (cp_uiEngine == P13_ENG_SGP4) && !sgp4init() )
+        cp_uiEngine = P13_ENG_PLAN13;
+#endif
+}
+
+
+// Gets the elements for a catalog or a binary element record
+void P13Satellite::getElements(P13Elements &p_el) const {
+    
+    p_el.c_lN   = cp_lN;
+    p_el.c_lYE  = cp_lYE;
+    p_el.c_lDE  = cp_lDE;
+    p_el.c_dTE  = cp_dTE;
+    p_el.c_dIN  = cp_dIN;
+    p_el.c_dRA  = cp_dRA;
+    p_el.c_dEC  = cp_dEC;
+    p_el.c_dWP  = cp_dWP;
+    p_el.c_dMA  = cp_dMA;
+    p_el.c_dMM  = cp_dMM;
+    p_el.c_dM2  = cp_dM2;
+    p_el.c_dRV  = cp_dRV;
+    p_el.c_dN0  = cp_dN0;
+    p_el.c_dA_0 = cp_dA_0;
+    p_el.c_dB_0 = cp_dB_0;
+    p_el.c_dPC  = cp_dPC;
+    p_el.c_dQD  = cp_dQD;
+    p_el.c_dWD  = cp_dWD;
+    p_el.c_dDC  = cp_dDC;
+#ifdef P13_SGP4
+    p_el.c_dBS  = cp_sgp4.c_dBS;
+#else
+    p_el.c_dBS  = 0.0;
+#endif
+#ifdef P13_LEAN
+    p_el.c_dGHAE = radians(g_scdG0) + ((double)(cp_lDE - g_sclDNG) + cp_dTE) * g_scdWE;
+    p_el.c_dCI   = cos(cp_dIN);
+    p_el.c_dSI   = sin(cp_dIN);
+#else
+    p_el.c_dGHAE = cp_dGHAE;
+    p_el.c_dCI   = cp_dCI;
+    p_el.c_dSI   = cp_dSI;
+#endif
+}
+
+
+void P13Satellite::predict(const P13DateTime &p_dt) {
+    
+    double l_dT;
+    
+    l_dT = (double)(p_dt.c_lDN - cp_lDE) + (p_dt.c_dTN - cp_dTE);   // Elapsed T since epoch, days
+
+#ifdef P13_LEAN
+    predictElapsed(l_dT, radians(g_scdG0) + ((double)(cp_lDE - g_sclDNG) + cp_dTE) * g_scdWE, cos(cp_dIN), sin(cp_dIN));
+#else
+    predictElapsed(l_dT, cp_dGHAE, cp_dCI, cp_dSI);
+#endif
+}
+
+
+// Predicts the satellite for a list of times. Epoch dependent terms are computed only once.
+// The results are stored as separate arrays (lat, lon, el, az), each with n elements.
+// Arrays not needed may be NULL, el/az are only calculated if an observer is given.
+// The satellite state is left at the last time of the list.
+void P13Satellite::predictBatch(const P13DateTime *p_adt, size_t p_n, double *p_adlat, double *p_adlon, double *p_adel, double *p_adaz, const P13Observer *p_obs) {
+    
+    size_t  l_ui;
+    double  l_dGHAE, l_dT;
+    P13Real l_dCI, l_dSI;
+    double  l_dlat, l_dlon, l_del, l_daz;
+    
+#ifdef P13_LEAN
+    l_dGHAE = radians(g_scdG0) + ((double)(cp_lDE - g_sclDNG) + cp_dTE) * g_scdWE;    // GHA Aries, epoch
+    l_dCI   = cos(cp_dIN);
+    l_dSI   = sin(cp_dIN);
+#else
+    l_dGHAE = cp_dGHAE;
+    l_dCI   = cp_dCI;
+    l_dSI   = cp_dSI;
+#endif
+    
+    for ( l_ui = 0; l_ui < p_n; l_ui++ )
+    {
+        l_dT = (double)(p_adt[l_ui].c_lDN - cp_lDE) + (p_adt[l_ui].c_dTN - cp_dTE);
+        
+        predictElapsed(l_dT, l_dGHAE, l_dCI, l_dSI);
+        
+        if ( p_adlat || p_adlon )
+        {
+            latlon(l_dlat, l_dlon);
+            
+            if ( p_adlat ) p_adlat[l_ui] = l_dlat;
+            if ( p_adlon ) p_adlon[l_ui] = l_dlon;
+        }
+        
+        if ( p_obs && (p_adel || p_adaz) )
+        {
+            elaz(*p_obs, l_del, l_daz);
+            
+            if ( p_adel ) p_adel[l_ui] = l_del;
+            if ( p_adaz ) p_adaz[l_ui] = l_daz;
+        }
+    }
+}
+
+
+// Predicts the satellite at elapsed time T (days) since epoch. GHAE is the GHA of Aries at
+// epoch, CI/SI are cos/sin of the inclination.
+void P13Satellite::predictElapsed(double p_dT, double p_dGHAE, P13Real p_dCI, P13Real p_dSI) {
+    
+    double   l_dGHAA, l_dM;
+    P13Real  l_dKD;
+    P13Real  l_dEA;
+    P13Real  l_dDNOM, l_dC_EA, l_dS_EA;
+    P13Real  l_dD;
+    P13Real  l_dAP, l_dRAAN;
+    P13State l_st;
+    
+    P13_PROF_BEGIN(P13_PROF_PREDICT);
+    
+#ifdef P13_SGP4
+    if ( (cp_uiEngine == P13_ENG_SGP4) && sgp4(l_st, p_dT) )
+    {
+        setState(l_st);
+        P13_PROF_END(P13_PROF_PREDICT);
+        return;
+    }
+#endif
+    
+    elapsedTerms(p_dT, p_dGHAE, l_dKD, l_dM, l_dAP, l_dRAAN, l_dGHAA);
+    
+    // Solve M = EA - EC*SIN(EA) for EA given M
+    l_dEA = fnkepler0(l_dM, cp_dEC);                         // Initial solution
+    
+    if ( cp_bWarm && cp_bEA )
+    {
+        // Warm start: Step from the last solution by dEA = dM / (1 - EC*cos(EA))
+        l_dD = l_dM - cp_dMprev;
+        
+        if ( l_dD >  PI ) l_dD -= 2.0 * PI;
+        if ( l_dD < -PI ) l_dD += 2.0 * PI;
+        
+        if ( fabs(l_dD) < 0.5 )
+            l_dEA = cp_dEAprev + l_dD / cp_dDNOMprev;
+    }
+    
+    P13_PROF_BEGIN(P13_PROF_KEPLER);
+    c_ulKeplerIter += fnkepler(l_dM, cp_dEC, cp_dKTol, l_dEA, l_dC_EA, l_dS_EA, l_dDNOM);
+    c_ulKeplerCalls++;
+    P13_PROF_END(P13_PROF_KEPLER);
+    
+    // Keep EA in range 0..2PI for the next warm start
+    if ( l_dEA < 0.0 )      l_dEA += 2.0 * PI;
+    if ( l_dEA > 2.0 * PI ) l_dEA -= 2.0 * PI;
+    
+    cp_dMprev    = l_dM;
+    cp_dEAprev   = l_dEA;
+    cp_dDNOMprev = l_dDNOM;
+    cp_bEA       = true;
+    
+    predictState(l_st, l_dKD, l_dC_EA, l_dS_EA, l_dDNOM, cos(l_dAP), sin(l_dAP), cos(l_dRAAN), sin(l_dRAAN), p_dCI, p_dSI, cos(-(P13Real)l_dGHAA), sin(-(P13Real)l_dGHAA));
+    setState(l_st);
+    
+    P13_PROF_END(P13_PROF_PREDICT);
+}
+
+
+// Terms of the elapsed time T (days) since epoch for GHA of Aries at epoch GHAE, see
+// fnelapsed()
+void P13Satellite::elapsedTerms(double p_dT, double p_dGHAE, P13Real &p_dKD, double &p_dM, P13Real &p_dAP, P13Real &p_dRAAN, double &p_dGHAA) const {
+    
+    fnelapsed(p_dT, p_dGHAE, cp_dDC, cp_dMA, cp_dMM, cp_dWP, cp_dWD, cp_dRA, cp_dQD, p_dKD, p_dM, p_dAP, p_dRAAN, p_dGHAA);
+}
+
+
+// Predicts the satellite for time dt and returns the state without changing the object
+// (no warm start of Kepler's equation, no counters), so one satellite can be shared by
+// several tasks or threads. predict() gives the same state into the members.
+P13State P13Satellite::propagate(const P13DateTime &p_dt) const {
+    
+    double   l_dT, l_dGHAE, l_dGHAA, l_dM;
+    P13Real  l_dCI, l_dSI, l_dKD;
+    P13Real  l_dEA, l_dDNOM, l_dC_EA, l_dS_EA;
+    P13Real  l_dAP, l_dRAAN;
+    P13State l_st;
+    
+    l_dT = (double)(p_dt.c_lDN - cp_lDE) + (p_dt.c_dTN - cp_dTE);   // Elapsed T since epoch, days
+    
+#ifdef P13_SGP4
+    if ( (cp_uiEngine == P13_ENG_SGP4) && sgp4(l_st, l_dT) )
+        return (l_st);
+#endif
+    
+#ifdef P13_LEAN
+    l_dGHAE = radians(g_scdG0) + ((double)(cp_lDE - g_sclDNG) + cp_dTE) * g_scdWE;
+    l_dCI   = cos(cp_dIN);
+    l_dSI   = sin(cp_dIN);
+#else
+    l_dGHAE = cp_dGHAE;
+    l_dCI   = cp_dCI;
+    l_dSI   = cp_dSI;
+#endif
+    
+    elapsedTerms(l_dT, l_dGHAE, l_dKD, l_dM, l_dAP, l_dRAAN, l_dGHAA);
+    
+    l_dEA = fnkepler0(l_dM, cp_dEC);
+    fnkepler(l_dM, cp_dEC, cp_dKTol, l_dEA, l_dC_EA, l_dS_EA, l_dDNOM);
+    
+    predictState(l_st, l_dKD, l_dC_EA, l_dS_EA, l_dDNOM, cos(l_dAP), sin(l_dAP), cos(l_dRAAN), sin(l_dRAAN), l_dCI, l_dSI, cos(-(P13Real)l_dGHAA), sin(-(P13Real)l_dGHAA));
+    
+    return (l_st);
+}
+
+
+// Elevation, azimuth, range and range rate of a state for an observer without changing
+// the object, see propagate()
+P13Look P13Satellite::look(const P13State &p_st, const P13Observer &p_obs) const {
+    
+    P13Look l_look;
+    
+    fnlook(p_st.c_vecS, p_st.c_vecV, p_obs, l_look);
+    
+    return (l_look);
+}
+
+
+// Latitude and longitude (deg) of a state, see propagate()
+void P13Satellite::latlon(const P13State &p_st, double &p_dlat, double &p_dlon) const {
+    
+    p_dlat = degrees(asin(p_st.c_vecS[2] / p_st.c_dRS));
+    p_dlon = degrees(atan2(p_st.c_vecS[1], p_st.c_vecS[0]));
+}
+
+
+// Copies a state into the members as after predict()
+void P13Satellite::setState(const P13State &p_st) {
+    
+    int l_ii;
+    
+    for ( l_ii = 0; l_ii < 3; l_ii++ )
+    {
+        c_vecSAT[l_ii] = p_st.c_vecSAT[l_ii];
+        c_vecVEL[l_ii] = p_st.c_vecVEL[l_ii];
+        c_vecS[l_ii]   = p_st.c_vecS[l_ii];
+        c_vecV[l_ii]   = p_st.c_vecV[l_ii];
+    }
+    
+    cp_dRS = p_st.c_dRS;
+    cp_dCG = p_st.c_dCG;
+    cp_dSG = p_st.c_dSG;
+}
+
+
+// Calculates the state vectors of the satellite into state st, see fnstate()
+void P13Satellite::predictState(P13State &p_st, P13Real p_dKD, P13Real p_dC_EA, P13Real p_dS_EA, P13Real p_dDNOM, P13Real p_dCW, P13Real p_dSW, P13Real p_dCQ, P13Real p_dSQ, P13Real p_dCI, P13Real p_dSI, P13Real p_dCG, P13Real p_dSG) const {
+    
+    fnstate(p_st, cp_dA_0, cp_dB_0, cp_dEC, cp_dN0, p_dKD, p_dC_EA, p_dS_EA, p_dDNOM, p_dCW, p_dSW, p_dCQ, p_dSQ, p_dCI, p_dSI, p_dCG, p_dSG);
+}
+
+
+void P13Satellite::latlon(double &p_dlat, double &p_dlon) {
+    
+    p_dlat = degrees(asin(c_vecS[2] / cp_dRS));
+    p_dlon = degrees(atan2(c_vecS[1], c_vecS[0]));
+}
+
+
+void P13Satellite::elaz(const P13Observer &p_obs, double &p_del, double &p_daz) {
+    
+    P13Look l_look;
+    
+    P13_PROF_BEGIN(P13_PROF_ELAZ);
+    
+    fnlook(c_vecS, c_vecV, p_obs, l_look);
+    
+    p_del  = l_look.c_dEL;
+    p_daz  = l_look.c_dAZ;
+    cp_dRR = l_look.c_dRR;   // Range rate needed for doppler calculation
+    
+    P13_PROF_END(P13_PROF_ELAZ);
+}
+
+// Generates the footprint for a satellite at satlat/satlon and calculates rectangular
+// x/y coordinates scaled to a map with size MapMaxX/MapMaxY. The coordinates are stored
+// in a two dimensional array. points[n][0] stores x and points[n][1] stores y.
+// The coordinates can be concatenated with lines to create a footprint outline.
+void P13Satellite::footprint(int p_aipoints[][2], int p_inumberofpoints, const int p_ciMapMaxX, const int p_ciMapMaxY, double &p_dsatlat, double &p_dsatlon) {
+    
+    P13Footprint l_fp(NULL, p_inumberofpoints);   // Circle generated on the fly
+    
+    l_fp.map(footprintRadius(), p_dsatlat, p_dsatlon, p_aipoints, p_ciMapMaxX, p_ciMapMaxY);
+}
+
+// Footprint of the satellite at the last prediction with a cached circle as lat/lon
+// (deg), each array with fp.points() elements.
+void P13Satellite::footprint(P13Footprint &p_fp, float *p_aflat, float *p_aflon) {
+    
+    double l_dlat, l_dlon;
+    
+    latlon(l_dlat, l_dlon);
+    p_fp.latlon(footprintRadius(), l_dlat, l_dlon, p_aflat, p_aflon);
+}
+
+
+// Footprint of the satellite at the last prediction with a cached circle as map
+// coordinates, see P13Footprint::map().
+void P13Satellite::footprint(P13Footprint &p_fp, int p_aipoints[][2], const int p_ciMapMaxX, const int p_ciMapMaxY, uint8_t *p_aubreak) {
+    
+    double l_dlat, l_dlon;
+    
+    latlon(l_dlat, l_dlon);
+    p_fp.map(footprintRadius(), l_dlat, l_dlon, p_aipoints, p_ciMapMaxX, p_ciMapMaxY, p_aubreak);
+}
+
+
+// Returns the radius of the footprint (angle at the center of the earth, deg)
+double P13Satellite::footprintRadius() {
+    
+    return (degrees(acos(g_scdRE / cp_dRS)));
+}
+
+
+// Returns the RX (dir = 0 or P13_FRX) or TX (dir = 1 or P13_FTX) frequency with doppler shift.
+double P13Satellite::doppler(double p_dfreqMHz, bool p_bodir) {
+    
+    double l_ddopplershift = dopplerOffset(p_dfreqMHz);
+    
+    if (p_bodir)  // TX
+    {
+        p_dfreqMHz = p_dfreqMHz - l_ddopplershift;
+    }
+    else          // RX
+    {
+        p_dfreqMHz = p_dfreqMHz + l_ddopplershift;
+    }
+
+    return (p_dfreqMHz);
+
+}
+
+// Returns just the change in frequency, relative to the observer, due to doppler shift.
+double P13Satellite::dopplerOffset(double p_dfreqMHz) {
+    return -p_dfreqMHz * cp_dRR / 299792.0;    //  Speed of light is 299792.0 km/s
+}
+
+
+// Sets the solver for Kepler's equation in predict(). With warm start the last solution
+// is used as start value, which saves iterations for sequential predictions with small
+// time steps (tracking loops, pass searches). tol is the limit for the change of EA
+// (radians) to end the iteration. Both c_ulKeplerCalls and c_ulKeplerIter count always,
+// so c_ulKeplerIter / c_ulKeplerCalls gives the average number of iterations per call.
+void P13Satellite::keplerMode(bool p_bwarm, double p_dtol) {
+    
+    cp_bWarm = p_bwarm;
+    cp_dKTol = p_dtol;
+}
+
+
+// Selects the engine of the predictions, P13_ENG_PLAN13 (default) or P13_ENG_SGP4. SGP4
+// adds the periodic terms of J2..J4 and a drag model with B*, so the error grows much
+// slower from epoch than with Plan13, at several times the cost per prediction. It is
+// used by predict(), predictBatch(), propagate() and everything based on them (passes,
+// ephemeris, illumination), P13Tracker predicts in full every step and P13Catalog is
+// always Plan13. SGP4 is implemented for the near earth orbits only; for periods of
+// 225 min and more (deep space, SDP4) and without P13_SGP4 the satellite stays with
+// Plan13. Predictions that fail in SGP4 (decayed orbit) fall back to Plan13 as well.
+// The engine is kept by tle(). Returns the engine in use.
+uint8_t P13Satellite::engine(uint8_t p_uiengine) {
+    
+    cp_uiEngine = P13_ENG_PLAN13;
+    
+#ifdef P13_SGP4
+    if ( (p_uiengine == P13_ENG_SGP4) && sgp4init() )
+        cp_uiEngine = P13_ENG_SGP4;
+#else
+    (void)p_uiengine;
+#endif
+    
+    return (cp_uiEngine);
+}
+
+
+#ifdef P13_SGP4
+// WGS-72 constants of SGP4 (the model the TLE are fitted with)
+static const double g_scd72RE   = 6378.135;               // Earth radius, km
+static const double g_scd72XKE  = 0.0743669161331734;     // sqrt(GM) in earth radii^1.5/min
+static const double g_scd72J2   =  0.001082616;           // Zonal harmonics
+static const double g_scd72J3   = -0.00000253881;         // -"-
+static const double g_scd72J4   = -0.00000165597;         // -"-
+static const double g_scdSGP4DS = 225.0;                  // Min. period of deep space orbits, min
+
+
+// Initialises the constants of the near earth SGP4 model from the elements. Returns
+// false for deep space orbits and elements SGP4 cannot use.
+bool P13Satellite::sgp4init() {
+    
+    double    l_dAK, l_dD1, l_dDEL, l_dADEL, l_dAO, l_dPO, l_dRP, l_dPERIGE;
+    double    l_dEO2, l_dOMEOSQ, l_dRTEOSQ, l_dCOSIO2, l_dCOSIO4, l_dCON42, l_dPINVSQ;
+    double    l_dS4, l_dQZMS24, l_dTSI, l_dETASQ, l_dEETA, l_dPSISQ, l_dCOEF, l_dCOEF1, l_dCC2, l_dCC3;
+    double    l_dT1, l_dT2, l_dT3, l_dXHDOT1, l_dCC1SQ, l_dJ3OJ2;
+    
+    P13Sgp4  &l_s = cp_sgp4;
+    
+    if ( (cp_dMM <= 0.0) || (l_s.c_dEC >= 1.0) )
+        return (false);
+    
+    l_dJ3OJ2   = g_scd72J3 / g_scd72J2;
+    
+    // Recover the Brouwer mean motion from the Kozai mean motion of the TLE
+    l_dEO2     = l_s.c_dEC * l_s.c_dEC;
+    l_dOMEOSQ  = 1.0 - l_dEO2;
+    l_dRTEOSQ  = sqrt(l_dOMEOSQ);
+    l_s.c_dCOSIO = cos(l_s.c_dIN);
+    l_s.c_dSINIO = sin(l_s.c_dIN);
+    l_dCOSIO2  = l_s.c_dCOSIO * l_s.c_dCOSIO;
+    
+    l_dAK      = pow(g_scd72XKE / (cp_dMM / 1440.0), 2.0 / 3.0);
+    l_dD1      = 0.75 * g_scd72J2 * (3.0 * l_dCOSIO2 - 1.0) / (l_dRTEOSQ * l_dOMEOSQ);
+    l_dDEL     = l_dD1 / (l_dAK * l_dAK);
+    l_dADEL    = l_dAK * (1.0 - l_dDEL * l_dDEL - l_dDEL * (1.0 / 3.0 + 134.0 * l_dDEL * l_dDEL / 81.0));
+    l_dDEL     = l_dD1 / (l_dADEL * l_dADEL);
+    l_s.c_dNO  = cp_dMM / 1440.0 / (1.0 + l_dDEL);
+    
+    if ( 2.0 * PI / l_s.c_dNO >= g_scdSGP4DS )
+        return (false);
+    
+    l_dAO      = pow(g_scd72XKE / l_s.c_dNO, 2.0 / 3.0);
+    l_dPO      = l_dAO * l_dOMEOSQ;
+    l_dCON42   = 1.0 - 5.0 * l_dCOSIO2;
+    l_s.c_dCON41 = -l_dCON42 - l_dCOSIO2 - l_dCOSIO2;
+    l_dPINVSQ  = 1.0 / (l_dPO * l_dPO);
+    l_dRP      = l_dAO * (1.0 - l_s.c_dEC);
+    
+    l_s.c_bSimple = (l_dRP < (220.0 / g_scd72RE + 1.0));
+    
+    // Density parameters, lowered for perigees below 156 km
+    l_dS4      = 78.0 / g_scd72RE + 1.0;
+    l_dQZMS24  = pow(42.0 / g_scd72RE, 4.0);
+    l_dPERIGE  = (l_dRP - 1.0) * g_scd72RE;
+    
+    if ( l_dPERIGE < 156.0 )
+    {
+        l_dS4 = (l_dPERIGE < 98.0) ? 20.0 : l_dPERIGE - 78.0;
+        l_dQZMS24 = pow((120.0 - l_dS4) / g_scd72RE, 4.0);
+        l_dS4 = l_dS4 / g_scd72RE + 1.0;
+    }
+    
+    l_dTSI     = 1.0 / (l_dAO - l_dS4);
+    l_s.c_dETA = l_dAO * l_s.c_dEC * l_dTSI;
+    l_dETASQ   = l_s.c_dETA * l_s.c_dETA;
+    l_dEETA    = l_s.c_dEC * l_s.c_dETA;
+    l_dPSISQ   = fabs(1.0 - l_dETASQ);
+    l_dCOEF    = l_dQZMS24 * pow(l_dTSI, 4.0);
+    l_dCOEF1   = l_dCOEF / pow(l_dPSISQ, 3.5);
+    
+    l_dCC2     = l_dCOEF1 * l_s.c_dNO * (l_dAO * (1.0 + 1.5 * l_dETASQ + l_dEETA * (4.0 + l_dETASQ)) +
+                 0.375 * g_scd72J2 * l_dTSI / l_dPSISQ * l_s.c_dCON41 * (8.0 + 3.0 * l_dETASQ * (8.0 + l_dETASQ)));
+    l_s.c_dCC1 = l_s.c_dBS * l_dCC2;
+    l_dCC3     = (l_s.c_dEC > 1.0E-4) ? -2.0 * l_dCOEF * l_dTSI * l_dJ3OJ2 * l_s.c_dNO * l_s.c_dSINIO / l_s.c_dEC : 0.0;
+    
+    l_s.c_dX1MTH2 = 1.0 - l_dCOSIO2;
+    l_s.c_dCC4 = 2.0 * l_s.c_dNO * l_dCOEF1 * l_dAO * l_dOMEOSQ *
+                 (l_s.c_dETA * (2.0 + 0.5 * l_dETASQ) + l_s.c_dEC * (0.5 + 2.0 * l_dETASQ) -
+                  g_scd72J2 * l_dTSI / (l_dAO * l_dPSISQ) *
+                  (-3.0 * l_s.c_dCON41 * (1.0 - 2.0 * l_dEETA + l_dETASQ * (1.5 - 0.5 * l_dEETA)) +
+                   0.75 * l_s.c_dX1MTH2 * (2.0 * l_dETASQ - l_dEETA * (1.0 + l_dETASQ)) * cos(2.0 * l_s.c_dWP)));
+    l_s.c_dCC5 = 2.0 * l_dCOEF1 * l_dAO * l_dOMEOSQ * (1.0 + 2.75 * (l_dETASQ + l_dEETA) + l_dEETA * l_dETASQ);
+    
+    // Secular rates of mean anomaly, argument of perigee and RAAN
+    l_dCOSIO4  = l_dCOSIO2 * l_dCOSIO2;
+    l_dT1      = 1.5 * g_scd72J2 * l_dPINVSQ * l_s.c_dNO;
+    l_dT2      = 0.5 * l_dT1 * g_scd72J2 * l_dPINVSQ;
+    l_dT3      = -0.46875 * g_scd72J4 * l_dPINVSQ * l_dPINVSQ * l_s.c_dNO;
+    
+    l_s.c_dMDOT    = l_s.c_dNO + 0.5 * l_dT1 * l_dRTEOSQ * l_s.c_dCON41 + 0.0625 * l_dT2 * l_dRTEOSQ * (13.0 - 78.0 * l_dCOSIO2 + 137.0 * l_dCOSIO4);
+    l_s.c_dARGPDOT = -0.5 * l_dT1 * l_dCON42 + 0.0625 * l_dT2 * (7.0 - 114.0 * l_dCOSIO2 + 395.0 * l_dCOSIO4) + l_dT3 * (3.0 - 36.0 * l_dCOSIO2 + 49.0 * l_dCOSIO4);
+    l_dXHDOT1      = -l_dT1 * l_s.c_dCOSIO;
+    l_s.c_dNODEDOT = l_dXHDOT1 + (0.5 * l_dT2 * (4.0 - 19.0 * l_dCOSIO2) + 2.0 * l_dT3 * (3.0 - 7.0 * l_dCOSIO2)) * l_s.c_dCOSIO;
+    
+    l_s.c_dOMGCOF  = l_s.c_dBS * l_dCC3 * cos(l_s.c_dWP);
+    l_s.c_dXMCOF   = (l_s.c_dEC > 1.0E-4) ? -2.0 / 3.0 * l_dCOEF * l_s.c_dBS / l_dEETA : 0.0;
+    l_s.c_dNODECF  = 3.5 * l_dOMEOSQ * l_dXHDOT1 * l_s.c_dCC1;
+    l_s.c_dT2COF   = 1.5 * l_s.c_dCC1;
+    l_s.c_dXLCOF   = -0.25 * l_dJ3OJ2 * l_s.c_dSINIO * (3.0 + 5.0 * l_s.c_dCOSIO) / max(1.0 + l_s.c_dCOSIO, 1.5E-12);
+    l_s.c_dAYCOF   = -0.5 * l_dJ3OJ2 * l_s.c_dSINIO;
+    l_s.c_dDELMO   = pow(1.0 + l_s.c_dETA * cos(l_s.c_dMA), 3.0);
+    l_s.c_dSINMAO  = sin(l_s.c_dMA);
+    l_s.c_dX7THM1  = 7.0 * l_dCOSIO2 - 1.0;
+    
+    // Drag terms to t^5, not used for a perigee below 220 km
+    l_dCC1SQ   = l_s.c_dCC1 * l_s.c_dCC1;
+    l_s.c_dD2  = 4.0 * l_dAO * l_dTSI * l_dCC1SQ;
+    l_dT1      = l_s.c_dD2 * l_dTSI * l_s.c_dCC1 / 3.0;
+    l_s.c_dD3  = (17.0 * l_dAO + l_dS4) * l_dT1;
+    l_s.c_dD4  = 0.5 * l_dT1 * l_dAO * l_dTSI * (221.0 * l_dAO + 31.0 * l_dS4) * l_s.c_dCC1;
+    l_s.c_dT3COF = l_s.c_dD2 + 2.0 * l_dCC1SQ;
+    l_s.c_dT4COF = 0.25 * (3.0 * l_s.c_dD3 + l_s.c_dCC1 * (12.0 * l_s.c_dD2 + 10.0 * l_dCC1SQ));
+    l_s.c_dT5COF = 0.2 * (3.0 * l_s.c_dD4 + 12.0 * l_s.c_dCC1 * l_s.c_dD3 + 6.0 * l_s.c_dD2 * l_s.c_dD2 + 15.0 * l_dCC1SQ * (2.0 * l_s.c_dD2 + l_dCC1SQ));
+    
+    return (true);
+}
+
+
+// Predicts the state at T days since epoch with SGP4. The position and velocity (TEME,
+// km, km/s) are the celestial coordinates, the geocentric ones follow with GMST.
+// Returns false if the orbit has decayed or the elements diverge.
+bool P13Satellite::sgp4(P13State &p_st, double p_dT) const {
+    
+    int     l_ii;
+    long    l_lD;
+    double  l_dt, l_dt2, l_dt3, l_dt4, l_dF, l_dGMST;
+    double  l_dXMDF, l_dARGPM, l_dNODEM, l_dMM, l_dTEMPA, l_dTEMPE, l_dTEMPL, l_dDELM;
+    double  l_dAM, l_dNM, l_dEM, l_dXLM, l_dAXNL, l_dAYNL, l_dXL, l_dU, l_dEO1, l_dTEM5;
+    double  l_dSINEO1, l_dCOSEO1, l_dECOSE, l_dESINE, l_dEL2, l_dPL, l_dRL, l_dRDOTL, l_dRVDOTL;
+    double  l_dBETAL, l_dSINU, l_dCOSU, l_dSU, l_dSIN2U, l_dCOS2U, l_dTEMP, l_dTEMP1, l_dTEMP2;
+    double  l_dMRT, l_dXNODE, l_dXINC, l_dMVT, l_dRVDOT;
+    double  l_dSINSU, l_dCOSSU, l_dSNOD, l_dCNOD, l_dSINI, l_dCOSI, l_dXMX, l_dXMY;
+    double  l_adU[3], l_adV[3];
+    
+    const P13Sgp4 &l_s = cp_sgp4;
+    
+    l_dt = p_dT * 1440.0;                                    // Minutes since epoch
+    
+    // Secular gravity and atmospheric drag
+    l_dXMDF  = l_s.c_dMA + l_s.c_dMDOT * l_dt;
+    l_dARGPM = l_s.c_dWP + l_s.c_dARGPDOT * l_dt;
+    l_dNODEM = l_s.c_dRA + l_s.c_dNODEDOT * l_dt;
+    l_dMM    = l_dXMDF;
+    l_dt2    = l_dt * l_dt;
+    l_dNODEM = l_dNODEM + l_s.c_dNODECF * l_dt2;
+    l_dTEMPA = 1.0 - l_s.c_dCC1 * l_dt;
+    l_dTEMPE = l_s.c_dBS * l_s.c_dCC4 * l_dt;
+    l_dTEMPL = l_s.c_dT2COF * l_dt2;
+    
+    if ( !l_s.c_bSimple )
+    {
+        l_dDELM  = l_s.c_dXMCOF * (pow(1.0 + l_s.c_dETA * cos(l_dXMDF), 3.0) - l_s.c_dDELMO);
+        l_dTEMP  = l_s.c_dOMGCOF * l_dt + l_dDELM;
+        l_dMM    = l_dXMDF + l_dTEMP;
+        l_dARGPM = l_dARGPM - l_dTEMP;
+        l_dt3    = l_dt2 * l_dt;
+        l_dt4    = l_dt3 * l_dt;
+        l_dTEMPA = l_dTEMPA - l_s.c_dD2 * l_dt2 - l_s.c_dD3 * l_dt3 - l_s.c_dD4 * l_dt4;
+        l_dTEMPE = l_dTEMPE + l_s.c_dBS * l_s.c_dCC5 * (sin(l_dMM) - l_s.c_dSINMAO);
+        l_dTEMPL = l_dTEMPL + l_s.c_dT3COF * l_dt3 + l_dt4 * (l_s.c_dT4COF + l_dt * l_s.c_dT5COF);
+    }
+    
+    l_dAM = pow(g_scd72XKE / l_s.c_dNO, 2.0 / 3.0) * l_dTEMPA * l_dTEMPA;
+    l_dNM = g_scd72XKE / pow(l_dAM, 1.5);
+    l_dEM = l_s.c_dEC - l_dTEMPE;
+    
+    if ( (l_dEM >= 1.0) || (l_dEM < -0.001) || (l_dAM < 0.95) )
+        return (false);
+    
+    if ( l_dEM < 1.0E-6 )
+        l_dEM = 1.0E-6;
+    
+    l_dMM    = l_dMM + l_s.c_dNO * l_dTEMPL;
+    l_dXLM   = l_dMM + l_dARGPM + l_dNODEM;
+    l_dNODEM = fmod(l_dNODEM, 2.0 * PI);
+    l_dARGPM = fmod(l_dARGPM, 2.0 * PI);
+    l_dXLM   = fmod(l_dXLM, 2.0 * PI);
+    
+    // Long period periodics
+    l_dAXNL  = l_dEM * cos(l_dARGPM);
+    l_dTEMP  = 1.0 / (l_dAM * (1.0 - l_dEM * l_dEM));
+    l_dAYNL  = l_dEM * sin(l_dARGPM) + l_dTEMP * l_s.c_dAYCOF;
+    l_dXL    = l_dXLM + l_dTEMP * l_s.c_dXLCOF * l_dAXNL;
+    
+    // Solve Kepler's equation for the eccentric longitude
+    l_dU     = fmod(l_dXL - l_dNODEM, 2.0 * PI);
+    l_dEO1   = l_dU;
+    l_dSINEO1 = 0.0;
+    l_dCOSEO1 = 1.0;
+    
+    for ( l_ii = 0; l_ii < 10; l_ii++ )
+    {
+        l_dSINEO1 = sin(l_dEO1);
+        l_dCOSEO1 = cos(l_dEO1);
+        l_dTEM5   = (l_dU - l_dAYNL * l_dCOSEO1 + l_dAXNL * l_dSINEO1 - l_dEO1) / (1.0 - l_dCOSEO1 * l_dAXNL - l_dSINEO1 * l_dAYNL);
+        l_dTEM5   = constrain(l_dTEM5, -0.95, 0.95);
+        l_dEO1   += l_dTEM5;
+        
+        if ( fabs(l_dTEM5) < 1.0E-12 )
+            break;
+    }
+    
+    // Short period periodics
+    l_dECOSE = l_dAXNL * l_dCOSEO1 + l_dAYNL * l_dSINEO1;
+    l_dESINE = l_dAXNL * l_dSINEO1 - l_dAYNL * l_dCOSEO1;
+    l_dEL2   = l_dAXNL * l_dAXNL + l_dAYNL * l_dAYNL;
+    l_dPL    = l_dAM * (1.0 - l_dEL2);
+    
+    if ( l_dPL < 0.0 )
+        return (false);
+    
+    l_dRL     = l_dAM * (1.0 - l_dECOSE);
+    l_dRDOTL  = sqrt(l_dAM) * l_dESINE / l_dRL;
+    l_dRVDOTL = sqrt(l_dPL) / l_dRL;
+    l_dBETAL  = sqrt(1.0 - l_dEL2);
+    l_dTEMP   = l_dESINE / (1.0 + l_dBETAL);
+    l_dSINU   = l_dAM / l_dRL * (l_dSINEO1 - l_dAYNL - l_dAXNL * l_dTEMP);
+    l_dCOSU   = l_dAM / l_dRL * (l_dCOSEO1 - l_dAXNL + l_dAYNL * l_dTEMP);
+    l_dSU     = atan2(l_dSINU, l_dCOSU);
+    l_dSIN2U  = (l_dCOSU + l_dCOSU) * l_dSINU;
+    l_dCOS2U  = 1.0 - 2.0 * l_dSINU * l_dSINU;
+    l_dTEMP   = 1.0 / l_dPL;
+    l_dTEMP1  = 0.5 * g_scd72J2 * l_dTEMP;
+    l_dTEMP2  = l_dTEMP1 * l_dTEMP;
+    
+    l_dMRT    = l_dRL * (1.0 - 1.5 * l_dTEMP2 * l_dBETAL * l_s.c_dCON41) + 0.5 * l_dTEMP1 * l_s.c_dX1MTH2 * l_dCOS2U;
+    l_dSU     = l_dSU - 0.25 * l_dTEMP2 * l_s.c_dX7THM1 * l_dSIN2U;
+    l_dXNODE  = l_dNODEM + 1.5 * l_dTEMP2 * l_s.c_dCOSIO * l_dSIN2U;
+    l_dXINC   = l_s.c_dIN + 1.5 * l_dTEMP2 * l_s.c_dCOSIO * l_s.c_dSINIO * l_dCOS2U;
+    l_dMVT    = l_dRDOTL - l_dNM * l_dTEMP1 * l_s.c_dX1MTH2 * l_dSIN2U / g_scd72XKE;
+    l_dRVDOT  = l_dRVDOTL + l_dNM * l_dTEMP1 * (l_s.c_dX1MTH2 * l_dCOS2U + 1.5 * l_s.c_dCON41) / g_scd72XKE;
+    
+    if ( l_dMRT < 1.0 )
+        return (false);
+    
+    // Orientation vectors, position and velocity
+    l_dSINSU = sin(l_dSU);
+    l_dCOSSU = cos(l_dSU);
+    l_dSNOD  = sin(l_dXNODE);
+    l_dCNOD  = cos(l_dXNODE);
+    l_dSINI  = sin(l_dXINC);
+    l_dCOSI  = cos(l_dXINC);
+    l_dXMX   = -l_dSNOD * l_dCOSI;
+    l_dXMY   =  l_dCNOD * l_dCOSI;
+    
+    l_adU[0] = l_dXMX * l_dSINSU + l_dCNOD * l_dCOSSU;
+    l_adU[1] = l_dXMY * l_dSINSU + l_dSNOD * l_dCOSSU;
+    l_adU[2] = l_dSINI * l_dSINSU;
+    
+    l_adV[0] = l_dXMX * l_dCOSSU - l_dCNOD * l_dSINSU;
+    l_adV[1] = l_dXMY * l_dCOSSU - l_dSNOD * l_dSINSU;
+    l_adV[2] = l_dSINI * l_dCOSSU;
+    
+    for ( l_ii = 0; l_ii < 3; l_ii++ )
+    {
+        p_st.c_vecSAT[l_ii] = l_dMRT * l_adU[l_ii] * g_scd72RE;
+        p_st.c_vecVEL[l_ii] = (l_dMVT * l_adU[l_ii] + l_dRVDOT * l_adV[l_ii]) * g_scd72RE * g_scd72XKE / 60.0;
+    }
+    
+    // Geocentric coordinates with the mean sidereal time (no nutation, TEME)
+    l_dF  = cp_dTE + p_dT;
+    l_lD  = (long)floor(l_dF);
+    l_dF -= (double)l_lD;
+    l_lD += cp_lDE - g_sclJ2K;
+    
+    l_dGMST = fngast(l_lD, l_dF - 0.5, ((double)l_lD + l_dF - 0.5) / 36525.0, 0.0);
+    
+    p_st.c_dCG = cos(-l_dGMST);
+    p_st.c_dSG = sin(-l_dGMST);
+    
+    p_st.c_vecS[0] = p_st.c_vecSAT[0] * p_st.c_dCG - p_st.c_vecSAT[1] * p_st.c_dSG;
+    p_st.c_vecS[1] = p_st.c_vecSAT[0] * p_st.c_dSG + p_st.c_vecSAT[1] * p_st.c_dCG;
+    p_st.c_vecS[2] = p_st.c_vecSAT[2];
+    
+    p_st.c_vecV[0] = p_st.c_vecVEL[0] * p_st.c_dCG - p_st.c_vecVEL[1] * p_st.c_dSG;
+    p_st.c_vecV[1] = p_st.c_vecVEL[0] * p_st.c_dSG + p_st.c_vecVEL[1] * p_st.c_dCG;
+    p_st.c_vecV[2] = p_st.c_vecVEL[2];
+    
+    p_st.c_dRS = l_dMRT * g_scd72RE;
+    
+    return (true);
+}
+#endif
+
+
+static const double g_scdPASSTOL  = 1.0 / 86400.0;     // Pass search time tolerance, days
+static const double g_scdPASSMIN  = 10.0 / 86400.0;    // Pass search minimum step, days
+static const double g_scdPASSMAX  = 300.0 / 86400.0;   // Pass search maximum fine step, days
+
+// Searches the next pass above elevation minel (deg) starting at time "from" within
+// maxdays days. Far from the observer the search steps by the time the sub satellite
+// point needs at least to reach the visibility circle of the observer at the maximum
+// ground track rate, so no pass can be skipped. Near the visibility circle the search
+// steps by 1/100 of the orbital period. AOS and LOS are refined by regula falsi, TCA
+// by golden section search. If the satellite is already above minel at "from", the
+// pass in progress is returned. A candidate that ends before "from" (e.g. a grazing
+// pass dipping below minel) is skipped, so AOS <= TCA <= LOS, LOS >= from and the
+// elevation at TCA is at least minel. Returns false if no complete pass was found
+// (e.g. geostationary satellites). The satellite state is left at LOS.
+bool P13Satellite::nextPass(const P13Observer &p_obs, const P13DateTime &p_dtfrom, P13Pass &p_pass, double p_dminel, double p_dmaxdays) {
+    
+    double l_dmine, l_dRA, l_dlam, l_drate, l_dstep;
+    double l_dt, l_dtprev, l_del, l_dpsi;
+    double l_dtaos, l_dttca, l_dtlos, l_dtmax, l_delmax;
+    double l_dro;
+    
+    l_dmine = radians(p_dminel);
+    l_dRA   = cp_dA_0 * (1.0 + cp_dEC) * 1.01;                                // Apogee radius, 1% margin for drag
+    l_dlam  = acos(g_scdRE * cos(l_dmine) / l_dRA) - l_dmine + radians(1.0);  // Largest visibility circle radius, 1 deg margin
+    l_drate = cp_dMM * (1.0 + cp_dEC) * (1.0 + cp_dEC) / pow(1.0 - cp_dEC * cp_dEC, 1.5) + g_scdWE;  // Max ground track rate, rad/day
+    
+    l_dstep = 2.0 * PI / cp_dMM / 100.0;
+    l_dstep = constrain(l_dstep, g_scdPASSMIN, g_scdPASSMAX);
+    
+    l_dro = sqrt(p_obs.c_vecO[0] * p_obs.c_vecO[0] + p_obs.c_vecO[1] * p_obs.c_vecO[1] + p_obs.c_vecO[2] * p_obs.c_vecO[2]);
+    
+    l_dt     = 0.0;
+    l_dtprev = 0.0;
+    l_del    = passel(p_obs, p_dtfrom, l_dt);
+    
+    if ( l_del >= p_dminel )
+    {
+        // Pass in progress, go back to AOS
+        do
+        {
+            l_dtprev = l_dt;
+            l_dt    -= l_dstep;
+            l_del    = passel(p_obs, p_dtfrom, l_dt);
+        }
+        while ( (l_del >= p_dminel) && (l_dt > -p_dmaxdays) );
+
+        if ( l_del >= p_dminel )
+            return (false);
+    }
+    
+    for ( ;; )
+    {
+        if ( l_del >= p_dminel )
+        {
+            l_dtaos = passedge(p_obs, p_dtfrom, l_dt, l_dtprev, p_dminel);
+        }
+        else
+        {
+            do
+            {
+                // Angle between sub satellite point and observer
+                l_dpsi = (c_vecS[0] * p_obs.c_vecO[0] + c_vecS[1] * p_obs.c_vecO[1] + c_vecS[2] * p_obs.c_vecO[2]) / (cp_dRS * l_dro);
+                l_dpsi = acos(constrain(l_dpsi, -1.0, 1.0));
+                
+                l_dtprev = l_dt;
+                l_dt    += max((l_dpsi - l_dlam) / l_drate, l_dstep);
+                
+                if ( l_dt > p_dmaxdays )
+                    return (false);
+                
+                l_del = passel(p_obs, p_dtfrom, l_dt);
+            }
+            while ( l_del < p_dminel );
+            
+            l_dtaos = passedge(p_obs, p_dtfrom, l_dtprev, l_dt, p_dminel);
+        }
+        
+        // Step through the pass to LOS and remember the highest sample, starting with
+        // AOS (above minel)
+        l_dt     = l_dtaos;
+        l_dtmax  = l_dtaos;
+        l_delmax = passel(p_obs, p_dtfrom, l_dtaos);
+        
+        do
+        {
+            l_dtprev = l_dt;
+            l_dt    += l_dstep;
+            l_del    = passel(p_obs, p_dtfrom, l_dt);
+            
+            if ( l_del > l_delmax )
+            {
+                l_delmax = l_del;
+                l_dtmax  = l_dt;
+            }
+        }
+        while ( (l_del >= p_dminel) && ((l_dt - l_dtaos) < p_dmaxdays) );
+        
+        if ( l_del >= p_dminel )
+            return (false);
+        
+        l_dtlos = passedge(p_obs, p_dtfrom, l_dt, l_dtprev, p_dminel);
+        
+        // Ended before "from": search on from the sample below minel after it
+        if ( l_dtlos >= 0.0 )
+            break;
+        
+        l_del = passel(p_obs, p_dtfrom, l_dt);
+    }
+    
+    l_dttca = passmax(p_obs, p_dtfrom, max(l_dtaos, l_dtmax - l_dstep), min(l_dtlos, l_dtmax + l_dstep));
+    
+    // Keep the highest sample if the search found a lower local maximum
+    if ( passel(p_obs, p_dtfrom, l_dttca) < l_delmax )
+        l_dttca = l_dtmax;
+    
+    p_pass.c_dtAOS = p_dtfrom;
+    p_pass.c_dtAOS.add(l_dtaos);
+    predict(p_pass.c_dtAOS);
+    elaz(p_obs, l_del, p_pass.c_dAzAOS);
+    
+    p_pass.c_dtTCA = p_dtfrom;
+    p_pass.c_dtTCA.add(l_dttca);
+    predict(p_pass.c_dtTCA);
+    elaz(p_obs, p_pass.c_dMaxEL, p_pass.c_dAzTCA);
+    
+    p_pass.c_dtLOS = p_dtfrom;
+    p_pass.c_dtLOS.add(l_dtlos);
+    predict(p_pass.c_dtLOS);
+    elaz(p_obs, l_del, p_pass.c_dAzLOS);
+    
+    return (true);
+}
+
+
+// Returns true if the satellite (at its last prediction) is in sunlight. The shadow
+// of the earth is taken as a cylinder (no penumbra), the sun vector of a P13Sun
+// predicted or refreshed close to the time of the satellite is sufficient.
+bool P13Satellite::sunlit(const P13Sun &p_sun) {
+    
+    P13Real l_dd;
+    
+    // Component of the satellite vector towards the sun
+    l_dd = c_vecSAT[0] * p_sun.c_vecSUN[0] + c_vecSAT[1] * p_sun.c_vecSUN[1] + c_vecSAT[2] * p_sun.c_vecSUN[2];
+    
+    // On the day side or outside the cylinder of the shadow
+    return ( (l_dd > (P13Real)0.0) || ((cp_dRS * cp_dRS - l_dd * l_dd) > (P13Real)(g_scdRE * g_scdRE)) );
+}
+
+
+// Coarse test if the satellite can rise above minel (deg) for an observer within window
+// days from time dt, from the distance of the observer from the orbit plane and the
+// visibility circle at apogee (no prediction). Returns false if it certainly stays
+// below, true if it may rise (a full prediction has to tell).
+bool P13Satellite::reachable(const P13Observer &p_obs, const P13DateTime &p_dt, double p_dwindow, double p_dminel) {
+    
+    double l_dT, l_dGHAE, l_dRAAN, l_dU;
+    double l_dSLA, l_dCLA, l_dLO;
+    
+    l_dT = (double)(p_dt.c_lDN - cp_lDE) + (p_dt.c_dTN - cp_dTE);   // Elapsed T since epoch, days
+    
+#ifdef P13_LEAN
+    l_dGHAE = radians(g_scdG0) + ((double)(cp_lDE - g_sclDNG) + cp_dTE) * g_scdWE;
+#else
+    l_dGHAE = cp_dGHAE;
+#endif
+    
+    l_dRAAN = cp_dRA + cp_dQD * l_dT * (1.0 - 3.5 * cp_dDC * l_dT);
+    
+    fnreachobs(p_obs, l_dSLA, l_dCLA, l_dLO);
+    
+    l_dU = cp_dWP + cp_dWD * l_dT * (1.0 - 3.5 * cp_dDC * l_dT) + cp_dMA + cp_dMM * l_dT * (1.0 - 1.5 * cp_dDC * l_dT);
+    
+    return (fnreach(cp_dA_0 * (1.0 + cp_dEC) * 1.01, cp_dEC, cos(cp_dIN), sin(cp_dIN), l_dRAAN - (l_dGHAE + g_scdWE * l_dT) - l_dLO, cp_dQD - g_scdWE,
+                    fmod(l_dU, 2.0 * PI), cp_dMM + cp_dWD, l_dSLA, l_dCLA, p_dminel, p_dwindow));
+}
+
+
+// Returns the illumination of the satellite (at its last prediction) and the observer
+// as P13_ILL_* flags. The sun at the observer is rotated from the celestial sun vector
+// with the GHA of Aries of the satellite, so the sun has only to be refreshed rarely
+// (see P13Sun::refresh()). Elevations minel and twilight in deg.
+uint8_t P13Satellite::illumination(const P13Sun &p_sun, const P13Observer &p_obs, double p_dminel, double p_dtwilight) {
+    
+    uint8_t l_uiflags = 0;
+    P13Real l_dx, l_dy, l_dr, l_du;
+    
+    Vec3 l_vecR; // Rangevec
+    
+    if ( sunlit(p_sun) )
+        l_uiflags |= P13_ILL_SUNLIT;
+    
+    // UP component of the geocentric sun vector, sin of the elevation of the sun
+    l_dx = p_sun.c_vecSUN[0] * cp_dCG - p_sun.c_vecSUN[1] * cp_dSG;
+    l_dy = p_sun.c_vecSUN[0] * cp_dSG + p_sun.c_vecSUN[1] * cp_dCG;
+    l_du = l_dx * p_obs.c_vecU[0] + l_dy * p_obs.c_vecU[1] + p_sun.c_vecSUN[2] * p_obs.c_vecU[2];
+    
+    if ( l_du < (P13Real)sin(radians(p_dtwilight)) )
+        l_uiflags |= P13_ILL_DARK;
+    
+    // Elevation of the satellite without asin()
+    l_vecR[0] = c_vecS[0] - p_obs.c_vecO[0];
+    l_vecR[1] = c_vecS[1] - p_obs.c_vecO[1];
+    l_vecR[2] = c_vecS[2] - p_obs.c_vecO[2];
+    
+    l_dr = sqrt(l_vecR[0] * l_vecR[0] + l_vecR[1] * l_vecR[1] + l_vecR[2] * l_vecR[2]);
+    l_du = l_vecR[0] * p_obs.c_vecU[0] + l_vecR[1] * p_obs.c_vecU[1] + l_vecR[2] * p_obs.c_vecU[2];
+    
+    if ( l_du > (P13Real)sin(radians(p_dminel)) * l_dr )
+        l_uiflags |= P13_ILL_ABOVE;
+    
+    return (l_uiflags);
+}
+
+
+// Predicts the satellite for n times and stores the illumination flags (see
+// illumination()) of each time into flags. The sun is only predicted again if the
+// last prediction is older than maxage (days). Returns the number of times with
+// the satellite visible to the eye (P13_ILL_VISIBLE), e.g. to check the steps of
+// a pass for a visible pass.
+size_t P13Satellite::illuminationBatch(const P13DateTime *p_adt, size_t p_n, const P13Observer &p_obs, P13Sun &p_sun, uint8_t *p_auflags, double p_dminel, double p_dtwilight, double p_dmaxage) {
+    
+    size_t  l_ui, l_uivisible = 0;
+    double  l_dGHAE, l_dT;
+    P13Real l_dCI, l_dSI;
+    
+#ifdef P13_LEAN
+    l_dGHAE = radians(g_scdG0) + ((double)(cp_lDE - g_sclDNG) + cp_dTE) * g_scdWE;    // GHA Aries, epoch
+    l_dCI   = cos(cp_dIN);
+    l_dSI   = sin(cp_dIN);
+#else
+    l_dGHAE = cp_dGHAE;
+    l_dCI   = cp_dCI;
+    l_dSI   = cp_dSI;
+#endif
+    
+    for ( l_ui = 0; l_ui < p_n; l_ui++ )
+    {
+        l_dT = (double)(p_adt[l_ui].c_lDN - cp_lDE) + (p_adt[l_ui].c_dTN - cp_dTE);
+        
+        predictElapsed(l_dT, l_dGHAE, l_dCI, l_dSI);
+        p_sun.refresh(p_adt[l_ui], p_dmaxage);
+        
+        p_auflags[l_ui] = illumination(p_sun, p_obs, p_dminel, p_dtwilight);
+        
+        if ( p_auflags[l_ui] == P13_ILL_VISIBLE )
+            l_uivisible++;
+    }
+    
+    return (l_uivisible);
+}
+
+
+// Predicts the satellite at base + dt (days) and returns the elevation for the observer
+double P13Satellite::passel(const P13Observer &p_obs, const P13DateTime &p_dtbase, double p_dt) {
+    
+    double l_del, l_daz;
+    P13DateTime l_dt(p_dtbase);
+    
+    l_dt.add(p_dt);
+    predict(l_dt);
+    elaz(p_obs, l_del, l_daz);
+    
+    return (l_del);
+}
+
+
+// Finds the time (days relative to base) where the elevation crosses minel between
+// dtbelow and dtabove by regula falsi (Illinois variant). Returns the end of the final
+// bracket on the side above minel, within the time tolerance of the crossing.
+double P13Satellite::passedge(const P13Observer &p_obs, const P13DateTime &p_dtbase, double p_dtbelow, double p_dtabove, double p_dminel) {
+    
+    int    l_ii;
+    int    l_iside = 0;
+    double l_dfbelow, l_dfabove, l_dtc, l_dfc;
+    
+    l_dfbelow = passel(p_obs, p_dtbase, p_dtbelow) - p_dminel;
+    l_dfabove = passel(p_obs, p_dtbase, p_dtabove) - p_dminel;
+    
+    for ( l_ii = 0; (l_ii < 32) && (fabs(p_dtabove - p_dtbelow) > g_scdPASSTOL); l_ii++ )
+    {
+        l_dtc = (p_dtbelow * l_dfabove - p_dtabove * l_dfbelow) / (l_dfabove - l_dfbelow);
+        l_dfc = passel(p_obs, p_dtbase, l_dtc) - p_dminel;
+        
+        if ( l_dfc >= 0.0 )
+        {
+            p_dtabove = l_dtc;
+            l_dfabove     = l_dfc;
+            
+            if ( l_iside == 1 )
+                l_dfbelow /= 2.0;
+            
+            l_iside = 1;
+        }
+        else
+        {
+            p_dtbelow = l_dtc;
+            l_dfbelow     = l_dfc;
+            
+            if ( l_iside == -1 )
+                l_dfabove /= 2.0;
+            
+            l_iside = -1;
+        }
+    }
+    
+    return (p_dtabove);
+}
+
+
+// Finds the time (days relative to base) of maximum elevation between dta and dtb
+// by golden section search
+double P13Satellite::passmax(const P13Observer &p_obs, const P13DateTime &p_dtbase, double p_dta, double p_dtb) {
+    
+    const double l_cdR = 0.61803398874989485;  // Golden ratio - 1
+    
+    double l_dt1, l_dt2, l_de1, l_de2;
+    
+    l_dt1 = p_dtb - l_cdR * (p_dtb - p_dta);
+    l_dt2 = p_dta + l_cdR * (p_dtb - p_dta);
+    l_de1 = passel(p_obs, p_dtbase, l_dt1);
+    l_de2 = passel(p_obs, p_dtbase, l_dt2);
+    
+    while ( (p_dtb - p_dta) > g_scdPASSTOL )
+    {
+        if ( l_de1 < l_de2 )
+        {
+            p_dta = l_dt1;
+            l_dt1 = l_dt2;
+            l_de1 = l_de2;
+            l_dt2 = p_dta + l_cdR * (p_dtb - p_dta);
+            l_de2 = passel(p_obs, p_dtbase, l_dt2);
+        }
+        else
+        {
+            p_dtb = l_dt2;
+            l_dt2 = l_dt1;
+            l_de2 = l_de1;
+            l_dt1 = p_dtb - l_cdR * (p_dtb - p_dta);
+            l_de1 = passel(p_obs, p_dtbase, l_dt1);
+        }
+    }
+    
+    return ((p_dta + p_dtb) / 2.0);
+}
+
+
+//----------------------------------------------------------------------
+//     _              ___  _ _______           
+//  __| |__ _ ______ | _ \/ |__ / __|_  _ _  _  
+// / _| / _` (_-<_-< |  _/| ||_ \__ \ || | \| |
+// \__|_\__,_/__/__/ |_|  |_|___/___/\_,_|_|\_|
+//                                             
+//----------------------------------------------------------------------
+
+// Engine P13_SUN_PLAN13 (default) or P13_SUN_MEEUS
+P13Sun::P13Sun(uint8_t p_uiengine) {
+    
+    cp_uiEngine = p_uiengine;
+    cp_bValid   = false;
+}
+
+
+P13Sun::~P13Sun() {
+    
+}
+
+
+// Selects the engine P13_SUN_PLAN13 or P13_SUN_MEEUS for the next predictions
+void P13Sun::engine(uint8_t p_uiengine) {
+    
+    cp_uiEngine = p_uiengine;
+    cp_bValid   = false;
+}
+
+
+void P13Sun::predict(const P13DateTime &p_dt) {
+    
+    long   l_lDN;
+    
+    double l_dTN;
+    double l_dT, l_dGHAE, l_dMRSE, l_dMASE, l_dTAS;
+    double l_dC, l_dS;
+    
+    P13_PROF_BEGIN(P13_PROF_SUN);
+    
+    l_lDN = p_dt.c_lDN;
+    l_dTN = p_dt.c_dTN;
+
+    if ( cp_uiEngine == P13_SUN_MEEUS )
+        l_dGHAE = predictMeeus(l_lDN, l_dTN);
+    else
+    {
+        l_dT    = (double)(l_lDN - g_sclDNG) + l_dTN;
+        l_dGHAE = radians(g_scdG0) + l_dT * g_scdWE;
+        
+        l_dMRSE = radians(g_scdG0) + l_dT * g_scdWW + PI;
+        l_dMASE = radians(g_scdMAS0 + l_dT * g_scdMASD);
+        l_dTAS  = l_dMRSE + g_scdEQC1 * sin(l_dMASE) + g_scdEQC2 * sin(2.0 * l_dMASE);
+        
+        // Sin/Cos Sun's true anomaly
+        l_dC = cos(l_dTAS);
+        l_dS = sin(l_dTAS);
+        
+        // Sun unit vector - CELESTIAL coords
+        c_vecSUN[0] = l_dC;
+        c_vecSUN[1] = l_dS * g_scdCNS;
+        c_vecSUN[2] = l_dS * g_scdSNS;
+    }
+    
+    // Obtain SUN unit vector in GEOCENTRIC coordinates
+    l_dC = cos(-l_dGHAE); 
+    l_dS = sin(-l_dGHAE); 
+        
+    c_vecH[0] = c_vecSUN[0] * l_dC - c_vecSUN[1] * l_dS;
+    c_vecH[1] = c_vecSUN[0] * l_dS + c_vecSUN[1] * l_dC;
+    c_vecH[2] = c_vecSUN[2];
+    
+    cp_lDN    = l_lDN;
+    cp_dTN    = l_dTN;
+    cp_bValid = true;
+    
+    P13_PROF_END(P13_PROF_SUN);
+}
+
+
+// Low precision solar coordinates (J. Meeus, Astronomical Algorithms, ch. 25, ~0.01 deg):
+// apparent longitude of the sun and true obliquity of the ecliptic give the unit vector
+// in the equatorial frame of date (c_vecSUN). Returns the Greenwich apparent sidereal
+// time (see fngast()), rad. The angles are calculated
+// from the days since J2000.0 and reduced to 0..360 deg before the conversion to
+// radians, see P13Real.
+double P13Sun::predictMeeus(long p_lDN, double p_dTN) {
+    
+    double  l_dD, l_dT;
+    double  l_dL0, l_dM, l_dC, l_dOM, l_dLA, l_dEPS;
+    P13Real l_dSL, l_dCE, l_dSE;
+    
+    l_dD = (double)(p_lDN - g_sclJ2K) + (p_dTN - 0.5);   // Days since J2000.0
+    l_dT = l_dD / 36525.0;                                // Julian centuries
+    
+    // Mean longitude, mean anomaly, equation of center and node of the moon
+    l_dL0  = fmod(280.46646 + 0.98564736 * l_dD + 0.0003032 * l_dT * l_dT, 360.0);
+    l_dM   = radians(fmod(357.52911 + 0.98560028 * l_dD - 0.0001537 * l_dT * l_dT, 360.0));
+    l_dC   = (1.914602 - 0.004817 * l_dT - 0.000014 * l_dT * l_dT) * sin(l_dM)
+           + (0.019993 - 0.000101 * l_dT) * sin(2.0 * l_dM)
+           +  0.000289 * sin(3.0 * l_dM);
+    l_dOM  = radians(fmod(125.04 - 0.05295377 * l_dD, 360.0));
+    
+    // Apparent longitude and true obliquity of the ecliptic
+    l_dLA  = radians(l_dL0 + l_dC - 0.00569 - 0.00478 * sin(l_dOM));
+    l_dEPS = radians(23.4392911 - 0.0130042 * l_dT + 0.00256 * cos(l_dOM));
+    
+    l_dSL = sin(l_dLA);
+    l_dCE = cos(l_dEPS);
+    l_dSE = sin(l_dEPS);
+    
+    // Sun unit vector - equatorial coordinates of date
+    c_vecSUN[0] = cos(l_dLA);
+    c_vecSUN[1] = l_dSL * l_dCE;
+    c_vecSUN[2] = l_dSL * l_dSE;
+    
+    return (fngast(p_lDN - g_sclJ2K, p_dTN - 0.5, l_dT, -0.00478 * sin(l_dOM) * l_dCE));
+}
+
+
+// Predicts the sun only if the last prediction is older than maxage (days, in both
+// directions). The celestial sun vector moves by about 1° per day, so it can be
+// reused for many steps of a satellite (see P13Satellite::illumination()), c_vecH
+// however is only valid for the time of the last prediction. Returns true if the
+// sun has been predicted.
+bool P13Sun::refresh(const P13DateTime &p_dt, double p_dmaxage) {
+    
+    if ( cp_bValid && (fabs((double)(p_dt.c_lDN - cp_lDN) + (p_dt.c_dTN - cp_dTN)) <= p_dmaxage) )
+        return (false);
+    
+    predict(p_dt);
+    
+    return (true);
+}
+
+
+void P13Sun::latlon(double &p_dlat, double &p_dlon) {
+    
+    p_dlat = degrees(asin(c_vecH[2]));
+    p_dlon = degrees(atan2(c_vecH[1], c_vecH[0]));
+}
+
+
+void P13Sun::elaz(const P13Observer &p_obs, double &p_del, double &p_daz) {
+    
+    // Copyright (c) 2021 Uwe Nagel
+    
+    P13Real l_dr, l_du, l_de, l_dn;
+    
+	Vec3 l_vecR; // Rangevec
+    
+    // Rangevec = Satvec - Obsvec
+    l_vecR[0] = c_vecH[0] * g_scdAU - p_obs.c_vecO[0] ;
+    l_vecR[1] = c_vecH[1] * g_scdAU - p_obs.c_vecO[1] ;
+    l_vecR[2] = c_vecH[2] * g_scdAU - p_obs.c_vecO[2] ;
+    
+    // Range magnitude
+    l_dr = sqrt(l_vecR[0] * l_vecR[0] + l_vecR[1] * l_vecR[1] + l_vecR[2] * l_vecR[2]);
+    
+    // Normalise Range vector
+    l_vecR[0] /= l_dr;
+    l_vecR[1] /= l_dr;
+    l_vecR[2] /= l_dr;
+    
+    // UP Component of unit range
+    l_du = l_vecR[0] * p_obs.c_vecU[0] + l_vecR[1] * p_obs.c_vecU[1] + l_vecR[2] * p_obs.c_vecU[2];
+    // EAST
+    l_de = l_vecR[0] * p_obs.c_vecE[0] + l_vecR[1] * p_obs.c_vecE[1];
+    //NORTH
+    l_dn = l_vecR[0] * p_obs.c_vecN[0] + l_vecR[1] * p_obs.c_vecN[1] + l_vecR[2] * p_obs.c_vecN[2];
+    
+    // Azimuth
+    p_daz = degrees(atan2(l_de, l_dn));
+
+    if (p_daz < 0.0)
+        p_daz += 360.0;
+    
+    // Elevation
+    p_del = degrees(asin(l_du));
+
+}
+
+
+// Generates the sunlight footprint at satlat/satlon and calculates rectangular
+// x/y coordinates scaled to a map with size MapMaxX/MapMaxY. The coordinates are stored
+// in a two dimensional array. points[n][0] stores x and points[n][1] stores y.
+// The coordinates can be concatenated with lines to create a footprint outline.
+//
+// This is a simplified aproach with no real calculation of the distance to the sun at a
+// specific time. It is assumed that the nearest and farest distance of the sun makes almost no
+// difference in footprint radius, it is always almost 0.5*PI. Therefore one astronomical
+// unit is used for the distance. The same algorithm is used as for the satellite footprint
+// except, that RS is replaced by AU.
+void P13Sun::footprint(int p_aipoints[][2], int p_inumberofpoints, const int p_ciMapMaxX, const int p_ciMapMaxY, double &p_dsunlat, double &p_dsunlon) {
+    
+    P13Footprint l_fp(NULL, p_inumberofpoints);   // Circle generated on the fly
+    
+    l_fp.map(footprintRadius(), p_dsunlat, p_dsunlon, p_aipoints, p_ciMapMaxX, p_ciMapMaxY);
+}
+
+
+// Sunlight footprint at the last prediction with a cached circle as lat/lon (deg),
+// each array with fp.points() elements.
+void P13Sun::footprint(P13Footprint &p_fp, float *p_aflat, float *p_aflon) {
+    
+    double l_dlat, l_dlon;
+    
+    latlon(l_dlat, l_dlon);
+    p_fp.latlon(footprintRadius(), l_dlat, l_dlon, p_aflat, p_aflon);
+}
+
+
+// Sunlight footprint at the last prediction with a cached circle as map coordinates,
+// see P13Footprint::map().
+void P13Sun::footprint(P13Footprint &p_fp, int p_aipoints[][2], const int p_ciMapMaxX, const int p_ciMapMaxY, uint8_t *p_aubreak) {
+    
+    double l_dlat, l_dlon;
+    
+    latlon(l_dlat, l_dlon);
+    p_fp.map(footprintRadius(), l_dlat, l_dlon, p_aipoints, p_ciMapMaxX, p_ciMapMaxY, p_aubreak);
+}
+
+
+// Returns the radius of the sunlight footprint (angle at the center of the earth, deg)
+double P13Sun::footprintRadius() {
+    
+    return (degrees(acos(g_scdRE / g_scdAU)));
+}
+
+
+//----------------------------------------------------------------------
+//     _              ___  _ ______  __ 
+//  __| |__ _ ______ | _ \/ |__ /  \/  |___  ___ _ _ 
+// / _| / _` (_-<_-< |  _/| ||_ \ |\/| / _ \/ _ \ ' \ _ 
+// \__|_\__,_/__/__/ |_|  |_|___/_|  |_\___/\___/_||_(_)
+// 
+//----------------------------------------------------------------------
+
+// Periodic terms of the lunar series (J. Meeus, Astronomical Algorithms, tables 47.A
+// and 47.B), the main terms down to about 0.004 deg: multiples of D, M, M' and F, and
+// the coefficients of longitude (1E-6 deg) and distance (m) or latitude (1E-6 deg).
+static const int8_t g_scaiMOONLR[][4] = {
+    { 0,  0,  1,  0 }, { 2,  0, -1,  0 }, { 2,  0,  0,  0 }, { 0,  0,  2,  0 },
+    { 0,  1,  0,  0 }, { 0,  0,  0,  2 }, { 2,  0, -2,  0 }, { 2, -1, -1,  0 },
+    { 2,  0,  1,  0 }, { 2, -1,  0,  0 }, { 0,  1, -1,  0 }, { 1,  0,  0,  0 },
+    { 0,  1,  1,  0 }, { 2,  0,  0, -2 }, { 0,  0,  1,  2 }, { 0,  0,  1, -2 },
+    { 4,  0, -1,  0 }, { 0,  0,  3,  0 }, { 4,  0, -2,  0 }, { 2,  1, -1,  0 },
+    { 2,  1,  0,  0 }, { 1,  0, -1,  0 }, { 1,  1,  0,  0 }, { 2, -1,  1,  0 }
+};
+
+static const long g_scalMOONL[] = {
+    6288774L, 1274027L,  658314L,  213618L, -185116L, -114332L,   58793L,   57066L,
+      53322L,   45758L,  -40923L,  -34720L,  -30383L,   15327L,  -12528L,   10980L,
+      10675L,   10034L,    8548L,   -7888L,   -6766L,   -5163L,    4987L,    4036L
+};
+
+static const long g_scalMOONR[] = {
+   -20905355L, -3699111L, -2955968L, -569925L,   48888L,   -3149L,  246158L, -152138L,
+     -170733L,  -204586L,  -129620L,  108743L,  104755L,   10321L,       0L,   79661L,
+      -34782L,   -23210L,   -21636L,   24208L,   30824L,   -8379L,  -16675L,  -12831L
+};
+
+static const int8_t g_scaiMOONB[][4] = {
+    { 0,  0,  0,  1 }, { 0,  0,  1,  1 }, { 0,  0,  1, -1 }, { 2,  0,  0, -1 },
+    { 2,  0, -1,  1 }, { 2,  0, -1, -1 }, { 2,  0,  0,  1 }, { 0,  0,  2,  1 },
+    { 2,  0,  1, -1 }, { 0,  0,  2, -1 }, { 2, -1,  0, -1 }, { 2,  0, -2, -1 },
+    { 2,  0,  1,  1 }
+};
+
+static const long g_scalMOONB[] = {
+    5128122L,  280602L,  277693L,  173237L,   55413L,   46271L,   32573L,   17198L,
+       9266L,    8822L,    8216L,    4324L,    4200L
+};
+
+static const uint8_t g_scuiMOONLR = sizeof(g_scalMOONL) / sizeof(g_scalMOONL[0]);
+static const uint8_t g_scuiMOONB  = sizeof(g_scalMOONB) / sizeof(g_scalMOONB[0]);
+
+static const double  g_scdMOONNODE = 1.0 / 24.0;   // Step of the nodes of predictBatch(), days
+
+
+// Topocentric elevation and azimuth (deg) of the geocentric position P (km)
+static void fnmoonelaz(const Vec3 p_vecP, const P13Observer &p_obs, double &p_del, double &p_daz) {
+    
+    P13Real l_dr, l_du, l_de, l_dn;
+    Vec3    l_vecR;
+    
+    l_vecR[0] = p_vecP[0] - p_obs.c_vecO[0];
+    l_vecR[1] = p_vecP[1] - p_obs.c_vecO[1];
+    l_vecR[2] = p_vecP[2] - p_obs.c_vecO[2];
+    
+    l_dr = sqrt(l_vecR[0] * l_vecR[0] + l_vecR[1] * l_vecR[1] + l_vecR[2] * l_vecR[2]);
+    
+    l_du = (l_vecR[0] * p_obs.c_vecU[0] + l_vecR[1] * p_obs.c_vecU[1] + l_vecR[2] * p_obs.c_vecU[2]) / l_dr;
+    l_de =  l_vecR[0] * p_obs.c_vecE[0] + l_vecR[1] * p_obs.c_vecE[1];
+    l_dn =  l_vecR[0] * p_obs.c_vecN[0] + l_vecR[1] * p_obs.c_vecN[1] + l_vecR[2] * p_obs.c_vecN[2];
+    
+    p_daz = degrees(atan2(l_de, l_dn));
+    
+    if ( p_daz < 0.0 )
+        p_daz += 360.0;
+    
+    p_del = degrees(asin(l_du));
+}
+
+
+// Rotates the celestial vector C by the sidereal time GST (rad) into geocentric G
+static void fncel2geo(const Vec3 p_vecC, double p_dGST, Vec3 p_vecG) {
+    
+    P13Real l_dC, l_dS;
+    
+    l_dC = cos(-p_dGST);
+    l_dS = sin(-p_dGST);
+    
+    p_vecG[0] = p_vecC[0] * l_dC - p_vecC[1] * l_dS;
+    p_vecG[1] = p_vecC[0] * l_dS + p_vecC[1] * l_dC;
+    p_vecG[2] = p_vecC[2];
+}
+
+
+// All vectors are zero until the first predict() (no footprint, see footprintRadius())
+P13Moon::P13Moon() {
+    
+    memset(c_vecMOON, 0, sizeof(Vec3));
+    memset(c_vecH,    0, sizeof(Vec3));
+    
+    c_dDist = 0.0;
+}
+
+
+P13Moon::~P13Moon() {
+    
+}
+
+
+void P13Moon::predict(const P13DateTime &p_dt) {
+    
+    Vec3   l_vecP;
+    double l_dnut;
+    
+    P13_PROF_BEGIN(P13_PROF_MOON);
+    
+    position(p_dt.c_lDN, p_dt.c_dTN, l_vecP, l_dnut);
+    
+    c_dDist = sqrt(l_vecP[0] * l_vecP[0] + l_vecP[1] * l_vecP[1] + l_vecP[2] * l_vecP[2]);
+    
+    c_vecMOON[0] = l_vecP[0] / c_dDist;
+    c_vecMOON[1] = l_vecP[1] / c_dDist;
+    c_vecMOON[2] = l_vecP[2] / c_dDist;
+    
+    fncel2geo(c_vecMOON, fngast(p_dt.c_lDN - g_sclJ2K, p_dt.c_dTN - 0.5, ((double)(p_dt.c_lDN - g_sclJ2K) + (p_dt.c_dTN - 0.5)) / 36525.0, l_dnut), c_vecH);
+    
+    P13_PROF_END(P13_PROF_MOON);
+}
+
+
+// Predicts the moon for n times start + i * step (step > 0, days) as separate arrays
+// (lat, lon, el, az), e.g. a table over a day for a station. Arrays not needed may be
+// NULL, el/az are only calculated if an observer is given. The series is only
+// evaluated at hourly nodes and the celestial position is interpolated in between
+// (cubic, error below 1 m), so a table of a day at one minute steps costs 26 series
+// instead of 1440. c_vecMOON, c_vecH and c_dDist are left at the last time.
+void P13Moon::predictBatch(const P13DateTime &p_dtstart, double p_dstep, size_t p_n, double *p_adlat, double *p_adlon, double *p_adel, double *p_adaz, const P13Observer *p_obs) {
+    
+    size_t      l_ui;
+    long        l_lk, l_lknode = 0;
+    uint8_t     l_uij;
+    bool        l_bnodes = false;
+    double      l_du, l_ds, l_adw[4], l_dnut = 0.0, l_dD, l_del, l_daz;
+    Vec3        l_avecN[4], l_vecC, l_vecP;
+    P13DateTime l_dt, l_dtnode;
+    
+    for ( l_ui = 0; l_ui < p_n; l_ui++ )
+    {
+        l_du = (double)l_ui * p_dstep / g_scdMOONNODE;
+        l_lk = (long)l_du;
+        l_ds = l_du - (double)l_lk;
+        
+        // Nodes k-1..k+2 around the time, shifted by one node in a time ordered table
+        if ( !l_bnodes || (l_lk != l_lknode) )
+        {
+            for ( l_uij = 0; l_uij < 4; l_uij++ )
+            {
+                if ( l_bnodes && (l_lk - l_lknode < 4) && (l_uij + l_lk - l_lknode < 4) )
+                {
+                    memcpy(l_avecN[l_uij], l_avecN[l_uij + l_lk - l_lknode], sizeof(Vec3));
+                }
+                else
+                {
+                    l_dtnode = p_dtstart;
+                    l_dtnode.add((double)(l_lk - 1 + l_uij) * g_scdMOONNODE);
+                    position(l_dtnode.c_lDN, l_dtnode.c_dTN, l_avecN[l_uij], l_dnut);
+                }
+            }
+            
+            l_lknode = l_lk;
+            l_bnodes = true;
+        }
+        
+        // Lagrange weights of the nodes -1, 0, 1, 2 for s = 0..1
+        l_adw[0] = -l_ds * (l_ds - 1.0) * (l_ds - 2.0) / 6.0;
+        l_adw[1] = (l_ds + 1.0) * (l_ds - 1.0) * (l_ds - 2.0) / 2.0;
+        l_adw[2] = -(l_ds + 1.0) * l_ds * (l_ds - 2.0) / 2.0;
+        l_adw[3] = (l_ds + 1.0) * l_ds * (l_ds - 1.0) / 6.0;
+        
+        for ( l_uij = 0; l_uij < 3; l_uij++ )
+            l_vecC[l_uij] = l_adw[0] * l_avecN[0][l_uij] + l_adw[1] * l_avecN[1][l_uij] + l_adw[2] * l_avecN[2][l_uij] + l_adw[3] * l_avecN[3][l_uij];
+        
+        // The nutation changes by less than 1E-6 deg per hour, the value of the last
+        // node is used
+        l_dt = p_dtstart;
+        l_dt.add((double)l_ui * p_dstep);
+        l_dD = (double)(l_dt.c_lDN - g_sclJ2K) + (l_dt.c_dTN - 0.5);
+        
+        fncel2geo(l_vecC, fngast(l_dt.c_lDN - g_sclJ2K, l_dt.c_dTN - 0.5, l_dD / 36525.0, l_dnut), l_vecP);
+        
+        c_dDist = sqrt(l_vecP[0] * l_vecP[0] + l_vecP[1] * l_vecP[1] + l_vecP[2] * l_vecP[2]);
+        
+        if ( p_adlat )
+            p_adlat[l_ui] = degrees(asin(l_vecP[2] / c_dDist));
+        
+        if ( p_adlon )
+            p_adlon[l_ui] = degrees(atan2(l_vecP[1], l_vecP[0]));
+        
+        if ( p_obs )
+        {
+            fnmoonelaz(l_vecP, *p_obs, l_del, l_daz);
+            
+            if ( p_adel )
+                p_adel[l_ui] = l_del;
+            
+            if ( p_adaz )
+                p_adaz[l_ui] = l_daz;
+        }
+        
+        if ( l_ui == p_n - 1 )
+        {
+            for ( l_uij = 0; l_uij < 3; l_uij++ )
+            {
+                c_vecMOON[l_uij] = l_vecC[l_uij] / c_dDist;
+                c_vecH[l_uij]    = l_vecP[l_uij] / c_dDist;
+            }
+        }
+    }
+}
+
+
+void P13Moon::latlon(double &p_dlat, double &p_dlon) {
+    
+    p_dlat = degrees(asin(c_vecH[2]));
+    p_dlon = degrees(atan2(c_vecH[1], c_vecH[0]));
+}
+
+
+// Topocentric elevation and azimuth (deg) of the moon at the last prediction
+void P13Moon::elaz(const P13Observer &p_obs, double &p_del, double &p_daz) {
+    
+    Vec3 l_vecP;
+    
+    l_vecP[0] = c_vecH[0] * c_dDist;
+    l_vecP[1] = c_vecH[1] * c_dDist;
+    l_vecP[2] = c_vecH[2] * c_dDist;
+    
+    fnmoonelaz(l_vecP, p_obs, p_del, p_daz);
+}
+
+
+// Generates the footprint of the moon (the area of the earth where the moon is above
+// the horizon) at moonlat/moonlon as map coordinates, as P13Sun::footprint()
+void P13Moon::footprint(int p_aipoints[][2], int p_inumberofpoints, const int p_ciMapMaxX, const int p_ciMapMaxY, double &p_dmoonlat, double &p_dmoonlon) {
+    
+    P13Footprint l_fp(NULL, p_inumberofpoints);   // Circle generated on the fly
+    
+    l_fp.map(footprintRadius(), p_dmoonlat, p_dmoonlon, p_aipoints, p_ciMapMaxX, p_ciMapMaxY);
+}
+
+
+// Footprint of the moon at the last prediction with a cached circle as lat/lon (deg),
+// each array with fp.points() elements.
+void P13Moon::footprint(P13Footprint &p_fp, float *p_aflat, float *p_aflon) {
+    
+    double l_dlat, l_dlon;
+    
+    latlon(l_dlat, l_dlon);
+    p_fp.latlon(footprintRadius(), l_dlat, l_dlon, p_aflat, p_aflon);
+}
+
+
+// Footprint of the moon at the last prediction with a cached circle as map coordinates,
+// see P13Footprint::map().
+void P13Moon::footprint(P13Footprint &p_fp, int p_aipoints[][2], const int p_ciMapMaxX, const int p_ciMapMaxY, uint8_t *p_aubreak) {
+    
+    double l_dlat, l_dlon;
+    
+    latlon(l_dlat, l_dlon);
+    p_fp.map(footprintRadius(), l_dlat, l_dlon, p_aipoints, p_ciMapMaxX, p_ciMapMaxY, p_aubreak);
+}
+
+
+// Returns the radius of the footprint of the moon at the last prediction (angle at the
+// center of the earth, deg)
+double P13Moon::footprintRadius() {
+    
+    if ( c_dDist <= g_scdRE )   // Not predicted yet
+        return (0.0);
+    
+    return (degrees(acos(g_scdRE / c_dDist)));
+}
+
+
+// Celestial position P (km, equatorial coordinates of date) of the moon from the lunar
+// series and the nutation in right ascension nut (deg) for fngast(). The arguments are
+// calculated from the days since J2000.0 and reduced to 0..360 deg; the terms with M
+// are multiplied by E (E^2 for 2M) for the eccentricity of the orbit of the earth.
+void P13Moon::position(long p_lDN, double p_dTN, Vec3 p_vecP, double &p_dnut) {
+    
+    uint8_t l_ui;
+    double  l_dD, l_dT, l_dE, l_dc, l_da;
+    double  l_dLP, l_dMD, l_dMS, l_dMM, l_dMF, l_dA1, l_dOM, l_dEPS;
+    double  l_dSL = 0.0, l_dSR = 0.0, l_dSB = 0.0;
+    double  l_dLA, l_dBE, l_dDI;
+    P13Real l_dCL, l_dSLA, l_dCB, l_dSB2, l_dCE, l_dSE;
+    
+    l_dD = (double)(p_lDN - g_sclJ2K) + (p_dTN - 0.5);   // Days since J2000.0
+    l_dT = l_dD / 36525.0;                                // Julian centuries
+    l_dE = 1.0 - 0.002516 * l_dT;
+    
+    // Mean longitude, elongation, anomalies of sun and moon, argument of latitude
+    l_dLP = radians(fmod(218.3164477 + 13.176396474584804 * l_dD, 360.0));
+    l_dMD = radians(fmod(297.8501921 + 12.190749114398358 * l_dD, 360.0));
+    l_dMS = radians(fmod(357.5291092 +  0.985600281749487 * l_dD, 360.0));
+    l_dMM = radians(fmod(134.9633964 + 13.064992950184804 * l_dD, 360.0));
+    l_dMF = radians(fmod( 93.2720950 + 13.229350240199864 * l_dD, 360.0));
+    l_dA1 = radians(fmod(119.75      +  0.003609828884326 * l_dD, 360.0));
+    l_dOM = radians(fmod(125.04452   -  0.052953764845996 * l_dD, 360.0));
+    
+    for ( l_ui = 0; l_ui < g_scuiMOONLR; l_ui++ )
+    {
+        l_da = g_scaiMOONLR[l_ui][0] * l_dMD + g_scaiMOONLR[l_ui][1] * l_dMS + g_scaiMOONLR[l_ui][2] * l_dMM + g_scaiMOONLR[l_ui][3] * l_dMF;
+        l_dc = (g_scaiMOONLR[l_ui][1] == 0) ? 1.0 : ((abs(g_scaiMOONLR[l_ui][1]) == 1) ? l_dE : l_dE * l_dE);
+        
+        l_dSL += l_dc * (double)g_scalMOONL[l_ui] * sin(l_da);
+        
+        if ( g_scalMOONR[l_ui] )
+            l_dSR += l_dc * (double)g_scalMOONR[l_ui] * cos(l_da);
+    }
+    
+    for ( l_ui = 0; l_ui < g_scuiMOONB; l_ui++ )
+    {
+        l_da = g_scaiMOONB[l_ui][0] * l_dMD + g_scaiMOONB[l_ui][1] * l_dMS + g_scaiMOONB[l_ui][2] * l_dMM + g_scaiMOONB[l_ui][3] * l_dMF;
+        l_dc = (g_scaiMOONB[l_ui][1] == 0) ? 1.0 : l_dE;
+        
+        l_dSB += l_dc * (double)g_scalMOONB[l_ui] * sin(l_da);
+    }
+    
+    // Additive terms (Venus, flattening of the earth)
+    l_dSL += 3958.0 * sin(l_dA1) + 1962.0 * sin(l_dLP - l_dMF);
+    l_dSB -= 2235.0 * sin(l_dLP);
+    
+    // Apparent longitude (nutation), latitude, distance and true obliquity
+    p_dnut = -0.00478 * sin(l_dOM);
+    l_dLA  = l_dLP + radians(l_dSL * 1.0E-6 + p_dnut);
+    l_dBE  = radians(l_dSB * 1.0E-6);
+    l_dDI  = 385000.56 + l_dSR * 1.0E-3;
+    l_dEPS = radians(23.4392911 - 0.0130042 * l_dT + 0.00256 * cos(l_dOM));
+    
+    l_dCL  = cos(l_dLA);
+    l_dSLA = sin(l_dLA);
+    l_dCB  = cos(l_dBE);
+    l_dSB2 = sin(l_dBE);
+    l_dCE  = cos(l_dEPS);
+    l_dSE  = sin(l_dEPS);
+    
+    // Ecliptic -> equatorial coordinates
+    p_vecP[0] = l_dDI * (l_dCB * l_dCL);
+    p_vecP[1] = l_dDI * (l_dCB * l_dSLA * l_dCE - l_dSB2 * l_dSE);
+    p_vecP[2] = l_dDI * (l_dCB * l_dSLA * l_dSE + l_dSB2 * l_dCE);
+    
+    p_dnut *= l_dCE;
+}
+
+
+
+//----------------------------------------------------------------------
+//     _              ___  _ ____ ___         _           _     _ 
+//  __| |__ _ ______ | _ \/ |__ /| __|__  ___| |_ _ __ _ _(_)_ _| |_ 
+// / _| / _` (_-<_-< |  _/| ||_ \| _/ _ \/ _ \  _| '_ \ '_| | ' \  _| 
+// \__|_\__,_/__/__/ |_|  |_|___/|_|\___/\___/\__| .__/_| |_|_||_\__| 
+//                                               |_| 
+//----------------------------------------------------------------------
+
+// Builds the circle for n points by angle addition (one sin/cos for all points). With
+// circle = NULL the points are generated while a footprint is calculated.
+P13Footprint::P13Footprint(P13Real p_adcircle[][2], int p_inumberofpoints) {
+    
+    int    l_ii;
+    double l_dC, l_dS;
+    
+    cp_adCircle = p_adcircle;
+    cp_iPoints  = p_inumberofpoints;
+    
+    cp_dCD = cos(2.0 * PI / (double)p_inumberofpoints);
+    cp_dSD = sin(2.0 * PI / (double)p_inumberofpoints);
+    
+    if ( cp_adCircle )
+    {
+        l_dC = 1.0;
+        l_dS = 0.0;
+    
+        for ( l_ii = 0; l_ii < p_inumberofpoints; l_ii++ )
+        {
+            cp_adCircle[l_ii][0] = l_dC;
+            cp_adCircle[l_ii][1] = l_dS;
+    
+            fnrotate(l_dC, l_dS, cp_dCD, cp_dSD);
+        }
+    }
+    
+    projection(P13_PROJ_EQUIRECT);
+    center(0.0, 0.0, 0.0);
+}
+
+
+P13Footprint::~P13Footprint() {
+    
+}
+
+
+int P13Footprint::points() {
+    
+    return (cp_iPoints);
+}
+
+
+// Sets the projection for map() and project(): P13_PROJ_EQUIRECT (default) or
+// P13_PROJ_AZIMUTHAL around lat/lon (deg). The azimuthal equidistant map is a circle
+// with the diameter min(MapMaxX, MapMaxY) in the middle of the map with the center of
+// the projection in the middle and its antipode at the border. North is up (for the
+// north pole as center the meridian lon is down).
+void P13Footprint::projection(uint8_t p_uiproj, double p_dlat, double p_dlon) {
+    
+    cp_uiProj = p_uiproj;
+    cp_dCLA0  = cos(radians(p_dlat));
+    cp_dSLA0  = sin(radians(p_dlat));
+    cp_dCLO0  = cos(radians(p_dlon));
+    cp_dSLO0  = sin(radians(p_dlon));
+}
+
+
+// Converts a single point lat/lon (deg) to x/y-coordinates in the current projection,
+// e.g. for the position of the satellite or the observer
+void P13Footprint::project(int &p_ix, int &p_iy, double p_dlat, double p_dlon, const int p_ciMapMaxX, const int p_ciMapMaxY) {
+    
+    double l_dcla;
+    
+    if ( cp_uiProj == P13_PROJ_AZIMUTHAL )
+    {
+        l_dcla = cos(radians(p_dlat));
+    
+        azimuthal(p_ix, p_iy, l_dcla * cos(radians(p_dlon)), l_dcla * sin(radians(p_dlon)), sin(radians(p_dlat)), p_ciMapMaxX, p_ciMapMaxY);
+    }
+    else
+        latlon2xy(p_ix, p_iy, p_dlat, p_dlon, p_ciMapMaxX, p_ciMapMaxY);
+}
+
+
+// Footprint with radius (deg, angle at the center of the earth) around lat/lon (deg)
+// as lat/lon arrays (deg), each with points() elements.
+void P13Footprint::latlon(double p_dradius, double p_dlat, double p_dlon, float *p_aflat, float *p_aflon) {
+    
+    int     l_ii;
+    P13Real l_dx, l_dy, l_dz;
+    
+    center(p_dradius, p_dlat, p_dlon);
+    
+    for ( l_ii = 0; l_ii < cp_iPoints; l_ii++ )
+    {
+        point(l_ii, l_dx, l_dy, l_dz);
+    
+        p_aflat[l_ii] = (float)degrees(asin(l_dz));
+        p_aflon[l_ii] = (float)pointlon(l_dx, l_dy);
+    }
+}
+
+
+// Footprint with radius (deg) around lat/lon (deg) as x/y coordinates of a map with
+// size MapMaxX/MapMaxY in the current projection. If break is given, break[i] is set
+// to 1 if the outline from point i-1 (point n-1 for i = 0) to point i crosses the date
+// line of the equirectangular map, so these points must not be connected when drawing
+// the outline as polyline.
+void P13Footprint::map(double p_dradius, double p_dlat, double p_dlon, int p_aipoints[][2], const int p_ciMapMaxX, const int p_ciMapMaxY, uint8_t *p_aubreak) {
+    
+    int     l_ii;
+    P13Real l_dx, l_dy, l_dz;
+    P13Real l_dlon, l_dlonprev = 0.0, l_dlonfirst = 0.0;
+    
+    P13_PROF_BEGIN(P13_PROF_FOOTPRINT);
+    
+    center(p_dradius, p_dlat, p_dlon);
+    
+    for ( l_ii = 0; l_ii < cp_iPoints; l_ii++ )
+    {
+        point(l_ii, l_dx, l_dy, l_dz);
+    
+        if ( cp_uiProj == P13_PROJ_AZIMUTHAL )
+        {
+            // Rotate point "around" through the longitude of the center
+            azimuthal(p_aipoints[l_ii][0], p_aipoints[l_ii][1], l_dx * cp_dCLO - l_dy * cp_dSLO, l_dx * cp_dSLO + l_dy * cp_dCLO, l_dz, p_ciMapMaxX, p_ciMapMaxY);
+    
+            if ( p_aubreak )
+                p_aubreak[l_ii] = 0;
+        }
+        else
+        {
+            l_dlon = pointlon(l_dx, l_dy);
+    
+            latlon2xy(p_aipoints[l_ii][0], p_aipoints[l_ii][1], degrees(asin(l_dz)), l_dlon, p_ciMapMaxX, p_ciMapMaxY);
+    
+            if ( p_aubreak )
+            {
+                if ( l_ii == 0 )
+                    l_dlonfirst = l_dlon;
+                else
+                    p_aubreak[l_ii] = (fabs(l_dlon - l_dlonprev) > (P13Real)180.0) ? 1 : 0;
+            }
+    
+            l_dlonprev = l_dlon;
+        }
+    }
+    
+    if ( p_aubreak && (cp_iPoints > 0) && (cp_uiProj != P13_PROJ_AZIMUTHAL) )
+        p_aubreak[0] = (fabs(l_dlonfirst - l_dlonprev) > (P13Real)180.0) ? 1 : 0;
+    
+    P13_PROF_END(P13_PROF_FOOTPRINT);
+}
+
+
+// Footprints of count satellites (at their last prediction) into one buffer with
+// count * points() elements (break alike), footprint k starts at element k * points().
+// Returns the number of points.
+int P13Footprint::map(P13Satellite *const p_apsat[], int p_icount, int p_aipoints[][2], const int p_ciMapMaxX, const int p_ciMapMaxY, uint8_t *p_aubreak) {
+    
+    int    l_ik;
+    double l_dlat, l_dlon;
+    
+    for ( l_ik = 0; l_ik < p_icount; l_ik++ )
+    {
+        p_apsat[l_ik]->latlon(l_dlat, l_dlon);
+        map(p_apsat[l_ik]->footprintRadius(), l_dlat, l_dlon, &p_aipoints[l_ik * cp_iPoints], p_ciMapMaxX, p_ciMapMaxY, p_aubreak ? &p_aubreak[l_ik * cp_iPoints] : NULL);
+    }
+    
+    return (p_icount * cp_iPoints);
+}
+
+
+// Footprints of all satellites of a catalog (at the last P13Catalog::predict()) into
+// one buffer, as for a list of satellites
+int P13Footprint::map(P13Catalog &p_cat, int p_aipoints[][2], const int p_ciMapMaxX, const int p_ciMapMaxY, uint8_t *p_aubreak) {
+    
+    uint16_t l_ui;
+    double   l_dlat, l_dlon;
+    
+    for ( l_ui = 0; l_ui < p_cat.count(); l_ui++ )
+    {
+        p_cat.latlon(l_ui, l_dlat, l_dlon);
+        map(degrees(acos(g_scdRE / p_cat.c_adRS[l_ui])), l_dlat, l_dlon, &p_aipoints[l_ui * cp_iPoints], p_ciMapMaxX, p_ciMapMaxY, p_aubreak ? &p_aubreak[l_ui * cp_iPoints] : NULL);
+    }
+    
+    return (p_cat.count() * cp_iPoints);
+}
+
+
+// Sets the terms for a circle of radius (deg) around lat/lon (deg), see point()
+void P13Footprint::center(double p_dradius, double p_dlat, double p_dlon) {
+    
+    double l_dsra, l_dcra, l_dsla, l_dcla;
+    
+    l_dsra = sin(radians(p_dradius));
+    l_dcra = cos(radians(p_dradius));
+    l_dsla = sin(radians(p_dlat));
+    l_dcla = cos(radians(p_dlat));
+    
+    cp_dA   = l_dcra * l_dcla;
+    cp_dB   = l_dsra * l_dsla;
+    cp_dC   = l_dcra * l_dsla;
+    cp_dD   = l_dsra * l_dcla;
+    cp_dSR  = l_dsra;
+    cp_dLO  = p_dlon;
+    cp_dCLO = cos(radians(p_dlon));
+    cp_dSLO = sin(radians(p_dlon));
+    
+    cp_dCC  = 1.0;
+    cp_dSC  = 0.0;
+}
+
+
+// Calculates point i of the current circle as unit vector. The circle centred on
+// lat = 0, lon = 0 is rotated "up" by the latitude of the center, but not yet "around"
+// through its longitude. Without circle buffer the points must be requested in
+// sequence 0..n-1.
+void P13Footprint::point(int p_ii, P13Real &p_dx, P13Real &p_dy, P13Real &p_dz) {
+    
+    P13Real l_dC, l_dS;
+    
+    if ( cp_adCircle )
+    {
+        l_dC = cp_adCircle[p_ii][0];
+        l_dS = cp_adCircle[p_ii][1];
+    }
+    else
+    {
+        l_dC = cp_dCC;
+        l_dS = cp_dSC;
+    
+        fnrotate(cp_dCC, cp_dSC, cp_dCD, cp_dSD);
+    }
+    
+    p_dx = cp_dA - cp_dB * l_dC;
+    p_dy = cp_dSR * l_dS;
+    p_dz = constrain(cp_dC + cp_dD * l_dC, (P13Real)-1.0, (P13Real)1.0);
+}
+
+
+// Returns the longitude (deg, -180..180) of a point from point(). The rotation
+// "around" through the longitude of the center is just an addition.
+P13Real P13Footprint::pointlon(P13Real p_dx, P13Real p_dy) {
+    
+    P13Real l_dlon;
+    
+    l_dlon = cp_dLO + degrees(atan2(p_dy, p_dx));
+    
+    if ( l_dlon >  (P13Real)180.0 ) l_dlon -= (P13Real)360.0;
+    if ( l_dlon < (P13Real)-180.0 ) l_dlon += (P13Real)360.0;
+    
+    return (l_dlon);
+}
+
+
+// Converts the geocentric unit vector X/Y/Z to x/y of the azimuthal equidistant map
+void P13Footprint::azimuthal(int &p_ix, int &p_iy, P13Real p_dX, P13Real p_dY, P13Real p_dZ, const int p_ciMapMaxX, const int p_ciMapMaxY) {
+    
+    P13Real l_de, l_dn, l_du, l_dh, l_dr;
+    
+    // East, north and up components at the center of the projection
+    l_de = -cp_dSLO0 * p_dX + cp_dCLO0 * p_dY;
+    l_dn = -cp_dSLA0 * (cp_dCLO0 * p_dX + cp_dSLO0 * p_dY) + cp_dCLA0 * p_dZ;
+    l_du =  cp_dCLA0 * (cp_dCLO0 * p_dX + cp_dSLO0 * p_dY) + cp_dSLA0 * p_dZ;
+    
+    l_dh = sqrt(l_de * l_de + l_dn * l_dn);
+    
+    // Angular distance from the center scaled to the radius of the map
+    if ( l_dh > (P13Real)0.0 )
+        l_dr = atan2(l_dh, l_du) / (P13Real)PI * (P13Real)(min(p_ciMapMaxX, p_ciMapMaxY) / 2) / l_dh;
+    else
+        l_dr = 0.0;
+    
+    p_ix = p_ciMapMaxX / 2 + (int)(l_dr * l_de);
+    p_iy = p_ciMapMaxY / 2 - (int)(l_dr * l_dn);
+}
+
+
+//----------------------------------------------------------------------
+//     _              ___  _ _____              _           _ 
+//  __| |__ _ ______ | _ \/ |__ /_   _|__ _ _ _ __ (_)_ _  __ _| |_ ___ _ _ 
+// / _| / _` (_-<_-< |  _/| ||_ \ | |/ -_) '_| '  \| | ' \/ _` |  _/ _ \ '_| 
+// \__|_\__,_/__/__/ |_|  |_|___/ |_|\___|_| |_|_|_|_|_||_\__,_|\__\___/_| 
+//                                                       
+//----------------------------------------------------------------------
+
+P13Terminator::P13Terminator(int16_t *p_airow, const int p_ciMapMaxX, const int p_ciMapMaxY, float *p_aflat, uint8_t *p_aumask, uint8_t *p_audirty) {
+    
+    int l_ix;
+    
+    cp_aiRow     = p_airow;
+    cp_afLat     = p_aflat;
+    cp_auMask    = p_aumask;
+    cp_auDirty   = p_audirty;
+    cp_iMaxX     = p_ciMapMaxX;
+    cp_iMaxY     = p_ciMapMaxY;
+    cp_bNorthDay = true;
+    
+    c_iDirtyFirst = -1;
+    c_iDirtyLast  = -1;
+    
+    // No valid row yet, so the first update() marks all columns dirty
+    for ( l_ix = 0; l_ix < cp_iMaxX; l_ix++ )
+        cp_aiRow[l_ix] = -1;
+}
+
+
+P13Terminator::~P13Terminator() {
+    
+}
+
+
+int P13Terminator::update(P13Sun &p_sun) {
+    
+    double l_dlat, l_dlon;
+    
+    p_sun.latlon(l_dlat, l_dlon);
+    
+    return (update(l_dlat, l_dlon));
+}
+
+
+// Calculates the terminator (sun elevation 0°, no refraction) for the sub-solar point
+// lat/lon (deg) with one atan2() per column, the hour angles of the column centres by
+// angle addition. Only the mask bits between the old and the new row of a changed column
+// are written. Returns the number of dirty columns.
+int P13Terminator::update(double p_dsunlat, double p_dsunlon) {
+    
+    int     l_ix, l_iy, l_iyold, l_iynew, l_iya, l_iyb, l_icount;
+    int     l_ibytes = (cp_iMaxX + 7) / 8;
+    bool    l_bnorthday, l_ball, l_bday;
+    uint8_t l_ubit;
+    double  l_dC, l_dS, l_dCD, l_dSD;
+    P13Real l_dsd, l_dcd, l_dlat;
+    
+    l_dsd = sin(radians(p_dsunlat));
+    l_dcd = cos(radians(p_dsunlat));
+    
+    // With the sun north of the equator the north is on the day side of the terminator
+    l_bnorthday = (l_dsd >= (P13Real)0.0);
+    
+    if ( l_dsd < (P13Real)0.0 )
+    {
+        l_dsd = -l_dsd;
+        l_dcd = -l_dcd;
+    }
+    
+    // Changing the side of the day all columns have to be redrawn
+    l_ball       = (l_bnorthday != cp_bNorthDay);
+    cp_bNorthDay = l_bnorthday;
+    
+    // Hour angle of the centre of column 0 and the step per column
+    l_dC  = cos(radians(-180.0 + 180.0 / (double)cp_iMaxX - p_dsunlon));
+    l_dS  = sin(radians(-180.0 + 180.0 / (double)cp_iMaxX - p_dsunlon));
+    l_dCD = cos(2.0 * PI / (double)cp_iMaxX);
+    l_dSD = sin(2.0 * PI / (double)cp_iMaxX);
+    
+    if ( cp_auDirty )
+        memset(cp_auDirty, 0, l_ibytes);
+    
+    c_iDirtyFirst = -1;
+    c_iDirtyLast  = -1;
+    l_icount      = 0;
+    
+    for ( l_ix = 0; l_ix < cp_iMaxX; l_ix++ )
+    {
+        // tan(lat) = -cos(H) * cos(decl) / sin(decl)
+        l_dlat = degrees(atan2(-(P13Real)l_dC * l_dcd, l_dsd));
+        
+        if ( cp_afLat )
+            cp_afLat[l_ix] = (float)l_dlat;
+        
+        // Number of rows with the pixel centre north of the terminator
+        l_iynew = (int)((((P13Real)90.0 - l_dlat) / (P13Real)180.0) * (P13Real)cp_iMaxY + (P13Real)0.5);
+        l_iynew = constrain(l_iynew, 0, cp_iMaxY);
+        l_iyold = cp_aiRow[l_ix];
+        
+        fnrotate(l_dC, l_dS, l_dCD, l_dSD);
+        
+        if ( (l_iynew == l_iyold) && !l_ball )
+            continue;
+        
+        cp_aiRow[l_ix] = l_iynew;
+        
+        if ( cp_auDirty )
+            cp_auDirty[l_ix >> 3] |= 0x80 >> (l_ix & 7);
+        
+        if ( c_iDirtyFirst < 0 )
+            c_iDirtyFirst = l_ix;
+        
+        c_iDirtyLast = l_ix;
+        l_icount++;
+        
+        if ( cp_auMask )
+        {
+            if ( l_ball || (l_iyold < 0) )
+            {
+                l_iya = 0;
+                l_iyb = cp_iMaxY;
+            }
+            else
+            {
+                l_iya = min(l_iyold, l_iynew);
+                l_iyb = max(l_iyold, l_iynew);
+            }
+            
+            l_ubit = 0x80 >> (l_ix & 7);
+            
+            for ( l_iy = l_iya; l_iy < l_iyb; l_iy++ )
+            {
+                l_bday = ((l_iy < l_iynew) == l_bnorthday);
+                
+                if ( l_bday )
+                    cp_auMask[l_iy * l_ibytes + (l_ix >> 3)] |= l_ubit;
+                else
+                    cp_auMask[l_iy * l_ibytes + (l_ix >> 3)] &= ~l_ubit;
+            }
+        }
+    }
+    
+    return (l_icount);
+}
+
+
+// Returns the terminator row of column x (number of rows north of the terminator)
+int P13Terminator::row(int p_ix) {
+    
+    return (cp_aiRow[p_ix]);
+}
+
+
+// Returns true if the rows north of the terminator are on the day side
+bool P13Terminator::northday() {
+    
+    return (cp_bNorthDay);
+}
+
+
+// Returns true if pixel x/y of the map is on the day side
+bool P13Terminator::day(int p_ix, int p_iy) {
+    
+    if ( cp_auMask )
+        return ((cp_auMask[p_iy * ((cp_iMaxX + 7) / 8) + (p_ix >> 3)] & (0x80 >> (p_ix & 7))) != 0);
+    
+    return ((p_iy < cp_aiRow[p_ix]) == cp_bNorthDay);
+}
+
+
+// Returns true if column x has been changed by the last update() (without dirty buffer
+// if it is in the range of the dirty columns)
+bool P13Terminator::dirty(int p_ix) {
+    
+    if ( cp_auDirty )
+        return ((cp_auDirty[p_ix >> 3] & (0x80 >> (p_ix & 7))) != 0);
+    
+    return ((p_ix >= c_iDirtyFirst) && (p_ix <= c_iDirtyLast) && (c_iDirtyFirst >= 0));
+}
+
+
+//----------------------------------------------------------------------
+//     _              ___  _ _______     _        _           
+//  __| |__ _ ______ | _ \/ |__ / __|__ _| |_ __ _| |___  __ _ 
+// / _| / _` (_-<_-< |  _/| ||_ \ (__/ _` |  _/ _` | / _ \/ _` |
+// \__|_\__,_/__/__/ |_|  |_|___/\___\__,_|\__\__,_|_\___/\__, |
+//                                                       |___/ 
+//----------------------------------------------------------------------
+
+#define P13_CAT_NDBL 22   // Number of double arrays in the catalog storage block
+
+P13Catalog::P13Catalog(uint16_t p_uicapacity) {
+    
+    double *l_pd;
+    
+    cp_uiCap   = p_uicapacity;
+    cp_uiCount = 0;
+    
+    c_uiErrFormat = c_uiErrChecksum = c_uiErrFull = 0;
+    c_uiCulled    = 0;
+    cp_pCullObs   = NULL;
+    cp_dCullMinEl = 0.0;
+    
+    cp_acNames = new char[(size_t)cp_uiCap * (P13_NAME_LEN + 1)];
+    cp_abCand  = new bool[cp_uiCap];
+    cp_alN     = new long[cp_uiCap];
+    cp_alDE    = new long[cp_uiCap];
+    cp_adBlock = new double[(size_t)cp_uiCap * P13_CAT_NDBL];
+    
+    l_pd = cp_adBlock;
+    
+    cp_adTE   = l_pd; l_pd += cp_uiCap;
+    cp_adMA   = l_pd; l_pd += cp_uiCap;
+    cp_adMM   = l_pd; l_pd += cp_uiCap;
+    cp_adDC   = l_pd; l_pd += cp_uiCap;
+    cp_adEC   = l_pd; l_pd += cp_uiCap;
+    cp_adN0   = l_pd; l_pd += cp_uiCap;
+    cp_adA_0  = l_pd; l_pd += cp_uiCap;
+    cp_adB_0  = l_pd; l_pd += cp_uiCap;
+    cp_adWP   = l_pd; l_pd += cp_uiCap;
+    cp_adWD   = l_pd; l_pd += cp_uiCap;
+    cp_adRA   = l_pd; l_pd += cp_uiCap;
+    cp_adQD   = l_pd; l_pd += cp_uiCap;
+    cp_adCI   = l_pd; l_pd += cp_uiCap;
+    cp_adSI   = l_pd; l_pd += cp_uiCap;
+    cp_adGHAE = l_pd; l_pd += cp_uiCap;
+    
+    c_adSX    = l_pd; l_pd += cp_uiCap;
+    c_adSY    = l_pd; l_pd += cp_uiCap;
+    c_adSZ    = l_pd; l_pd += cp_uiCap;
+    c_adVX    = l_pd; l_pd += cp_uiCap;
+    c_adVY    = l_pd; l_pd += cp_uiCap;
+    c_adVZ    = l_pd; l_pd += cp_uiCap;
+    c_adRS    = l_pd;
+}
+
+
+P13Catalog::~P13Catalog() {
+    
+    delete[] cp_acNames;
+    delete[] cp_alN;
+    delete[] cp_alDE;
+    delete[] cp_adBlock;
+    delete[] cp_abCand;
+}
+
+
+// Adds a satellite from a TLE. Returns the index in the catalog, -1 if the catalog is full
+// or -1 - P13_TLE_EFORMAT / P13_TLE_ECHECKSUM if the TLE has errors.
+int P13Catalog::add(const char *p_ccSatName, const char *p_ccl1, const char *p_ccl2) {
+    
+    int         l_istat;
+    P13Elements l_el;
+    
+    l_istat = tleparse(l_el, p_ccl1, strlen(p_ccl1), p_ccl2, strlen(p_ccl2));
+    
+    if ( l_istat != P13_TLE_OK )
+        return (-1 - l_istat);
+    
+    return (store(p_ccSatName, strlen(p_ccSatName), l_el));
+}
+
+
+// Adds a copy of the elements of a satellite. Returns the index in the catalog or -1 if the
+// catalog is full.
+int P13Catalog::add(const P13Satellite &p_sat) {
+    
+    P13Elements l_el;
+    
+    p_sat.getElements(l_el);
+    
+    return (store(p_sat.c_ccSatName, strlen(p_sat.c_ccSatName), l_el));
+}
+
+
+// Stores the elements at the end of the catalog. The name is cut to P13_NAME_LEN characters.
+int P13Catalog::store(const char *p_ccnm, size_t p_uinmlen, const P13Elements &p_el) {
+    
+    uint16_t l_ui;
+    char    *l_pcnm;
+    
+    if ( cp_uiCount >= cp_uiCap )
+        return (-1);
+    
+    if ( p_uinmlen > P13_NAME_LEN )
+        p_uinmlen = P13_NAME_LEN;
+    
+    l_ui   = cp_uiCount++;
+    l_pcnm = &cp_acNames[(size_t)l_ui * (P13_NAME_LEN + 1)];
+    
+    cp_abCand[l_ui] = true;   // Not culled until the next prefilter()
+    
+    memcpy(l_pcnm, p_ccnm, p_uinmlen);
+    l_pcnm[p_uinmlen] = '\0';
+    
+    cp_alN[l_ui]    = p_el.c_lN;
+    cp_alDE[l_ui]   = p_el.c_lDE;
+    cp_adTE[l_ui]   = p_el.c_dTE;
+    cp_adMA[l_ui]   = p_el.c_dMA;
+    cp_adMM[l_ui]   = p_el.c_dMM;
+    cp_adDC[l_ui]   = p_el.c_dDC;
+    cp_adEC[l_ui]   = p_el.c_dEC;
+    cp_adN0[l_ui]   = p_el.c_dN0;
+    cp_adA_0[l_ui]  = p_el.c_dA_0;
+    cp_adB_0[l_ui]  = p_el.c_dB_0;
+    cp_adWP[l_ui]   = p_el.c_dWP;
+    cp_adWD[l_ui]   = p_el.c_dWD;
+    cp_adRA[l_ui]   = p_el.c_dRA;
+    cp_adQD[l_ui]   = p_el.c_dQD;
+    cp_adCI[l_ui]   = p_el.c_dCI;
+    cp_adSI[l_ui]   = p_el.c_dSI;
+    cp_adGHAE[l_ui] = p_el.c_dGHAE;
+    
+    c_adSX[l_ui] = c_adSY[l_ui] = c_adSZ[l_ui] = 0.0;
+    c_adVX[l_ui] = c_adVY[l_ui] = c_adVZ[l_ui] = 0.0;
+    c_adRS[l_ui] = 0.0;
+    
+    return ((int)l_ui);
+}
+
+
+// Loads a TLE file (2- or 3-line format, e.g. from CelesTrak) from a memory buffer with
+// length len and appends the satellites to the catalog. The lines are parsed in place.
+// Returns the number of satellites added, rejected TLEs are counted in c_uiErrFormat,
+// c_uiErrChecksum and c_uiErrFull.
+uint16_t P13Catalog::load(const char *p_ccbuf, size_t p_uilen) {
+    
+    size_t l_ui0, l_ui1;
+    
+    c_uiErrFormat = c_uiErrChecksum = c_uiErrFull = 0;
+    cp_ccLdName   = cp_ccLdL1 = NULL;
+    cp_uiLdName   = cp_uiLdL1 = 0;
+    cp_uiLdCount  = 0;
+    
+    for ( l_ui0 = 0; l_ui0 < p_uilen; l_ui0 = l_ui1 + 1 )
+    {
+        for ( l_ui1 = l_ui0; (l_ui1 < p_uilen) && (p_ccbuf[l_ui1] != '\n'); l_ui1++ )
+            ;
+        
+        loadline(&p_ccbuf[l_ui0], l_ui1 - l_ui0);
+    }
+    
+    return (cp_uiLdCount);
+}
+
+
+#ifdef ARDUINO
+// Loads a TLE file from a stream (e.g. a file on a SD card, a serial port or a network
+// client) with the timed reads of Stream, so gaps in the data shorter than the timeout
+// of the stream (setTimeout(), 1 s by default) do not end the file. Loading ends when no
+// character arrives within the timeout. Only the current and the two previous non-empty
+// lines are kept in a buffer on the stack, longer lines than P13_TLE_LINE_MAX are cut.
+uint16_t P13Catalog::load(Stream &p_stream) {
+    
+    char   l_aclines[3][P13_TLE_LINE_MAX];
+    char   l_c;
+    int    l_iline = 0;
+    size_t l_uilen;
+    
+    c_uiErrFormat = c_uiErrChecksum = c_uiErrFull = 0;
+    cp_ccLdName   = cp_ccLdL1 = NULL;
+    cp_uiLdName   = cp_uiLdL1 = 0;
+    cp_uiLdCount  = 0;
+    
+    for ( ;; )
+    {
+        l_uilen = p_stream.readBytesUntil('\n', l_aclines[l_iline], P13_TLE_LINE_MAX);
+        
+        if ( l_uilen == 0 )
+        {
+            // Empty line or end of the stream, only a timed read of the next character tells
+            if ( p_stream.readBytes(&l_c, 1) == 0 )
+                break;
+            
+            if ( l_c == '\n' )
+                continue;
+            
+            l_aclines[l_iline][0] = l_c;
+            l_uilen = 1 + p_stream.readBytesUntil('\n', &l_aclines[l_iline][1], P13_TLE_LINE_MAX - 1);
+        }
+        
+        if ( l_uilen == P13_TLE_LINE_MAX )
+        {
+            // Skip the rest of a long line
+            while ( (p_stream.readBytes(&l_c, 1) == 1) && (l_c != '\n') )
+                ;
+        }
+        
+        // Lines 1 and 2 of a 3LE refer to the two previous buffers, so rotate after
+        // a line which loadline() keeps only
+        if ( loadline(l_aclines[l_iline], l_uilen) )
+            l_iline = (l_iline + 1) % 3;
+    }
+    
+    return (cp_uiLdCount);
+}
+#endif
+
+
+// Loads count binary element records (see P13Satellite::load()), e.g. a file from
+// extras/tle2bin in memory mapped flash or a C array of records in PROGMEM (progmem).
+// Invalid records are counted as for load(). Returns the number of satellites added.
+uint16_t P13Catalog::loadRecords(const uint8_t *p_aurecs, uint16_t p_uicount, bool p_bprogmem) {
+    
+    uint16_t       l_ui, l_uiadded = 0;
+    int            l_istat;
+    P13Elements    l_el;
+    char           l_acname[P13_NAME_LEN + 1];
+    uint8_t        l_aurec[P13_REC_SIZE];
+    const uint8_t *l_curec;
+    
+    c_uiErrFormat = c_uiErrChecksum = c_uiErrFull = 0;
+    
+    for ( l_ui = 0; l_ui < p_uicount; l_ui++ )
+    {
+        l_curec = &p_aurecs[(size_t)l_ui * P13_REC_SIZE];
+        
+        if ( p_bprogmem )
+        {
+            memcpy_P(l_aurec, l_curec, P13_REC_SIZE);
+            l_curec = l_aurec;
+        }
+        
+        l_istat = recparse(l_el, l_acname, l_curec);
+        
+        if ( l_istat == P13_TLE_EFORMAT )
+            c_uiErrFormat++;
+        else if ( l_istat == P13_TLE_ECHECKSUM )
+            c_uiErrChecksum++;
+        else if ( store(l_acname, strlen(l_acname), l_el) < 0 )
+            c_uiErrFull++;
+        else
+            l_uiadded++;
+    }
+    
+    return (l_uiadded);
+}
+
+
+// Processes one line of a TLE file while loading. Returns false for an empty line (the
+// buffer of the line is not referenced).
+bool P13Catalog::loadline(const char *p_ccline, size_t p_uilen) {
+    
+    int         l_istat;
+    P13Elements l_el;
+    
+    // Strip line end and trailing blanks
+    while ( (p_uilen > 0) && ((p_ccline[p_uilen - 1] == '\r') || (p_ccline[p_uilen - 1] == ' ')) )
+        p_uilen--;
+    
+    if ( p_uilen == 0 )
+        return (false);
+    
+    if ( (p_uilen >= 68) && (p_ccline[0] == '1') && (p_ccline[1] == ' ') )
+    {
+        cp_ccLdL1 = p_ccline;
+        cp_uiLdL1 = p_uilen;
+    }
+    else if ( (p_uilen >= 68) && (p_ccline[0] == '2') && (p_ccline[1] == ' ') && cp_ccLdL1 )
+    {
+        l_istat = tleparse(l_el, cp_ccLdL1, cp_uiLdL1, p_ccline, p_uilen);
+        
+        if ( l_istat == P13_TLE_EFORMAT )
+            c_uiErrFormat++;
+        else if ( l_istat == P13_TLE_ECHECKSUM )
+            c_uiErrChecksum++;
+        else if ( store(cp_ccLdName ? cp_ccLdName : "", cp_uiLdName, l_el) < 0 )
+            c_uiErrFull++;
+        else
+            cp_uiLdCount++;
+        
+        cp_ccLdName = cp_ccLdL1 = NULL;
+        cp_uiLdName = cp_uiLdL1 = 0;
+    }
+    else if ( (p_uilen >= 68) && (p_ccline[0] == '2') && (p_ccline[1] == ' ') )
+    {
+        c_uiErrFormat++;         // Line 2 without line 1
+        
+        cp_ccLdName = NULL;
+        cp_uiLdName = 0;
+    }
+    else
+    {
+        if ( cp_ccLdL1 )         // Line 1 without line 2
+            c_uiErrFormat++;
+        
+        if ( (p_uilen > 2) && (p_ccline[0] == '0') && (p_ccline[1] == ' ') )  // Name line with "0 " prefix
+        {
+            p_ccline += 2;
+            p_uilen  -= 2;
+        }
+        
+        cp_ccLdName = p_ccline;
+        cp_uiLdName = p_uilen;
+        cp_ccLdL1   = NULL;
+        cp_uiLdL1   = 0;
+    }
+    
+    return (true);
+}
+
+
+void P13Catalog::clear() {
+    
+    cp_uiCount = 0;
+}
+
+
+uint16_t P13Catalog::count() {
+    
+    return (cp_uiCount);
+}
+
+
+uint16_t P13Catalog::capacity() {
+    
+    return (cp_uiCap);
+}
+
+
+const char *P13Catalog::name(uint16_t p_uiidx) {
+    
+    return (&cp_acNames[(size_t)p_uiidx * (P13_NAME_LEN + 1)]);
+}
+
+
+long P13Catalog::number(uint16_t p_uiidx) {
+    
+    return (cp_alN[p_uiidx]);
+}
+
+
+// Predicts all satellites of the catalog for the same time. The loop works on the element
+// arrays in one linear sweep with the same helpers as P13Satellite::propagate(), so the
+// results are bit-identical to predict() without warm start.
+void P13Catalog::predict(const P13DateTime &p_dt) {
+    
+    predict(p_dt, 0, cp_uiCount);
+}
+
+
+// Predicts the satellites first..last-1 of the catalog, e.g. one block of P13Parallel
+void P13Catalog::predict(const P13DateTime &p_dt, uint16_t p_uifirst, uint16_t p_uilast) {
+    
+    uint16_t l_ui;
+    
+    double   l_dT, l_dM, l_dGHAA;
+    P13Real  l_dKD, l_dAP, l_dRAAN;
+    P13Real  l_dEA, l_dEC;
+    P13Real  l_dDNOM, l_dC_EA, l_dS_EA;
+    P13State l_st;
+    
+    p_uilast = min(p_uilast, cp_uiCount);
+    
+    for ( l_ui = p_uifirst; l_ui < p_uilast; l_ui++ )
+    {
+        l_dT = (double)(p_dt.c_lDN - cp_alDE[l_ui]) + (p_dt.c_dTN - cp_adTE[l_ui]);   // Elapsed T since epoch, days
+        
+        fnelapsed(l_dT, cp_adGHAE[l_ui], cp_adDC[l_ui], cp_adMA[l_ui], cp_adMM[l_ui], cp_adWP[l_ui], cp_adWD[l_ui], cp_adRA[l_ui], cp_adQD[l_ui], l_dKD, l_dM, l_dAP, l_dRAAN, l_dGHAA);
+        
+        // Solve M = EA - EC*SIN(EA) for EA given M
+        l_dEC = cp_adEC[l_ui];
+        l_dEA = fnkepler0(l_dM, l_dEC);
+        
+        fnkepler(l_dM, l_dEC, 1.0E-5, l_dEA, l_dC_EA, l_dS_EA, l_dDNOM);
+        
+        fnstate(l_st, cp_adA_0[l_ui], cp_adB_0[l_ui], l_dEC, cp_adN0[l_ui], l_dKD, l_dC_EA, l_dS_EA, l_dDNOM, cos(l_dAP), sin(l_dAP), cos(l_dRAAN), sin(l_dRAAN), cp_adCI[l_ui], cp_adSI[l_ui], cos(-(P13Real)l_dGHAA), sin(-(P13Real)l_dGHAA));
+        
+        c_adRS[l_ui] = l_st.c_dRS;
+        c_adSX[l_ui] = l_st.c_vecS[0];
+        c_adSY[l_ui] = l_st.c_vecS[1];
+        c_adSZ[l_ui] = l_st.c_vecS[2];
+        c_adVX[l_ui] = l_st.c_vecV[0];
+        c_adVY[l_ui] = l_st.c_vecV[1];
+        c_adVZ[l_ui] = l_st.c_vecV[2];
+    }
+}
+
+
+void P13Catalog::latlon(uint16_t p_uiidx, double &p_dlat, double &p_dlon) {
+    
+    p_dlat = degrees(asin(c_adSZ[p_uiidx] / c_adRS[p_uiidx]));
+    p_dlon = degrees(atan2(c_adSY[p_uiidx], c_adSX[p_uiidx]));
+}
+
+
+void P13Catalog::elaz(uint16_t p_uiidx, const P13Observer &p_obs, double &p_del, double &p_daz) {
+    
+    double l_dr, l_du, l_de, l_dn;
+    
+    Vec3 l_vecR; // Rangevec
+    
+    l_vecR[0] = c_adSX[p_uiidx] - p_obs.c_vecO[0];
+    l_vecR[1] = c_adSY[p_uiidx] - p_obs.c_vecO[1];
+    l_vecR[2] = c_adSZ[p_uiidx] - p_obs.c_vecO[2];
+    
+    l_dr = sqrt(l_vecR[0] * l_vecR[0] + l_vecR[1] * l_vecR[1] + l_vecR[2] * l_vecR[2]);
+    
+    l_du = (l_vecR[0] * p_obs.c_vecU[0] + l_vecR[1] * p_obs.c_vecU[1] + l_vecR[2] * p_obs.c_vecU[2]) / l_dr;
+    l_de = (l_vecR[0] * p_obs.c_vecE[0] + l_vecR[1] * p_obs.c_vecE[1]) / l_dr;
+    l_dn = (l_vecR[0] * p_obs.c_vecN[0] + l_vecR[1] * p_obs.c_vecN[1] + l_vecR[2] * p_obs.c_vecN[2]) / l_dr;
+    
+    p_daz = degrees(atan2(l_de, l_dn));
+    
+    if (p_daz < 0.0)
+        p_daz += 360.0;
+    
+    p_del = degrees(asin(l_du));
+}
+
+
+// Rules out the satellites which certainly stay below minel (deg) for the observer
+// within window days from time dt, see P13Satellite::reachable(). visible() for the
+// same observer object within the window (and minel not below this one) predicts only
+// the remaining candidates. Returns the number of candidates, the number of culled
+// satellites is kept in c_uiCulled (cull rate c_uiCulled / count()). Satellites added
+// later are candidates.
+uint16_t P13Catalog::prefilter(const P13Observer &p_obs, const P13DateTime &p_dt, double p_dwindow, double p_dminel) {
+    
+    uint16_t l_ui, l_uin = 0;
+    double   l_dT, l_dRAAN, l_dU, l_dSLA, l_dCLA, l_dLO;
+    
+    fnreachobs(p_obs, l_dSLA, l_dCLA, l_dLO);
+    
+    for ( l_ui = 0; l_ui < cp_uiCount; l_ui++ )
+    {
+        l_dT    = (double)(p_dt.c_lDN - cp_alDE[l_ui]) + (p_dt.c_dTN - cp_adTE[l_ui]);
+        l_dRAAN = cp_adRA[l_ui] + cp_adQD[l_ui] * l_dT * (1.0 - 3.5 * cp_adDC[l_ui] * l_dT);
+        l_dU    = cp_adWP[l_ui] + cp_adWD[l_ui] * l_dT * (1.0 - 3.5 * cp_adDC[l_ui] * l_dT) +
+                  cp_adMA[l_ui] + cp_adMM[l_ui] * l_dT * (1.0 - 1.5 * cp_adDC[l_ui] * l_dT);
+        
+        cp_abCand[l_ui] = fnreach(cp_adA_0[l_ui] * (1.0 + cp_adEC[l_ui]) * 1.01, cp_adEC[l_ui], cp_adCI[l_ui], cp_adSI[l_ui],
+                                  l_dRAAN - (cp_adGHAE[l_ui] + g_scdWE * l_dT) - l_dLO, cp_adQD[l_ui] - g_scdWE,
+                                  fmod(l_dU, 2.0 * PI), cp_adMM[l_ui] + cp_adWD[l_ui], l_dSLA, l_dCLA, p_dminel, p_dwindow);
+        
+        if ( cp_abCand[l_ui] )
+            l_uin++;
+    }
+    
+    c_uiCulled    = cp_uiCount - l_uin;
+    cp_pCullObs   = &p_obs;
+    cp_dtCull0    = p_dt;
+    cp_dtCull1    = p_dt;
+    cp_dtCull1.add(p_dwindow);
+    cp_dCullMinEl = p_dminel;
+    
+    return (l_uin);
+}
+
+
+// Predicts the whole catalog (or the candidates of prefilter()) for the time dt and
+// returns the number of satellites above elevation minel (deg) for the observer.
+// Indices, elevations and azimuths of up to max satellites are stored in idx, el and az
+// (el and az may be NULL). Below-horizon satellites are rejected on the up component of
+// the unnormalised range vector, so asin/atan2 are only calculated for the visible ones.
+uint16_t P13Catalog::visible(const P13Observer &p_obs, const P13DateTime &p_dt, uint16_t *p_auiidx, double *p_adel, double *p_adaz, uint16_t p_uimax, double p_dminel) {
+    
+    uint16_t l_ui, l_uin;
+    double   l_dsmin, l_dRx, l_dRy, l_dRz, l_dru, l_dr;
+    double   l_del, l_daz;
+    bool     l_bcull;
+    
+    // Prefilter valid for this observer, time and min. elevation
+    l_bcull = (cp_pCullObs == &p_obs) && (p_dminel >= cp_dCullMinEl) &&
+              ((double)(p_dt.c_lDN - cp_dtCull0.c_lDN) + (p_dt.c_dTN - cp_dtCull0.c_dTN) >= 0.0) &&
+              ((double)(cp_dtCull1.c_lDN - p_dt.c_lDN) + (cp_dtCull1.c_dTN - p_dt.c_dTN) >= 0.0);
+    
+    if ( !l_bcull )
+        predict(p_dt);
+    
+    l_dsmin = sin(radians(p_dminel));
+    l_uin   = 0;
+    
+    for ( l_ui = 0; (l_ui < cp_uiCount) && (l_uin < p_uimax); l_ui++ )
+    {
+        if ( l_bcull )
+        {
+            if ( !cp_abCand[l_ui] )
+                continue;
+            
+            predict(p_dt, l_ui, l_ui + 1);
+        }
+        
+        l_dRx = c_adSX[l_ui] - p_obs.c_vecO[0];
+        l_dRy = c_adSY[l_ui] - p_obs.c_vecO[1];
+        l_dRz = c_adSZ[l_ui] - p_obs.c_vecO[2];
+        
+        l_dru = l_dRx * p_obs.c_vecU[0] + l_dRy * p_obs.c_vecU[1] + l_dRz * p_obs.c_vecU[2];
+        
+        if ( (l_dsmin >= 0.0) && (l_dru < 0.0) )
+            continue;
+        
+        l_dr = sqrt(l_dRx * l_dRx + l_dRy * l_dRy + l_dRz * l_dRz);
+        
+        if ( l_dru < l_dsmin * l_dr )
+            continue;
+        
+        elaz(l_ui, p_obs, l_del, l_daz);
+        
+        p_auiidx[l_uin] = l_ui;
+        
+        if ( p_adel ) p_adel[l_uin] = l_del;
+        if ( p_adaz ) p_adaz[l_uin] = l_daz;
+        
+        l_uin++;
+    }
+    
+    return (l_uin);
+}
+
+
+
+//----------------------------------------------------------------------
+//     _              ___  _ ____ ___  _                              ___      _   
+//  __| |__ _ ______ | _ \/ |__ // _ \| |__ ___ ___ _ ___ _____ _ _  / __| ___| |_ 
+// / _| / _` (_-<_-< |  _/| ||_ \ (_) | '_ (_-</ -_) '_\ V / -_) '_| \__ \/ -_)  _|
+// \__|_\__,_/__/__/ |_|  |_|___/\___/|_.__/__/\___|_|  \_/\___|_|   |___/\___|\__|
+//                                                      
+//----------------------------------------------------------------------
+
+#define P13_OBS_NREAL 13   // Number of P13Real arrays in the observer set storage block
+
+P13ObserverSet::P13ObserverSet(uint16_t p_uicapacity) {
+    
+    P13Real *l_pd;
+    
+    cp_uiCap   = p_uicapacity;
+    cp_uiCount = 0;
+    
+    cp_adBlock = new P13Real[(size_t)cp_uiCap * P13_OBS_NREAL];
+    
+    l_pd = cp_adBlock;
+    
+    cp_adOX = l_pd; l_pd += cp_uiCap;
+    cp_adOY = l_pd; l_pd += cp_uiCap;
+    cp_adOZ = l_pd; l_pd += cp_uiCap;
+    cp_adUX = l_pd; l_pd += cp_uiCap;
+    cp_adUY = l_pd; l_pd += cp_uiCap;
+    cp_adUZ = l_pd; l_pd += cp_uiCap;
+    cp_adEX = l_pd; l_pd += cp_uiCap;
+    cp_adEY = l_pd; l_pd += cp_uiCap;
+    cp_adNX = l_pd; l_pd += cp_uiCap;
+    cp_adNY = l_pd; l_pd += cp_uiCap;
+    cp_adNZ = l_pd; l_pd += cp_uiCap;
+    cp_adVX = l_pd; l_pd += cp_uiCap;
+    cp_adVY = l_pd;
+}
+
+
+P13ObserverSet::~P13ObserverSet() {
+    
+    delete[] cp_adBlock;
+}
+
+
+// Adds a copy of the station vectors of an observer. Returns the index in the set or -1
+// if the set is full.
+int P13ObserverSet::add(const P13Observer &p_obs) {
+    
+    uint16_t l_ui;
+    
+    if ( cp_uiCount >= cp_uiCap )
+        return (-1);
+    
+    l_ui = cp_uiCount++;
+    
+    cp_adOX[l_ui] = p_obs.c_vecO[0];
+    cp_adOY[l_ui] = p_obs.c_vecO[1];
+    cp_adOZ[l_ui] = p_obs.c_vecO[2];
+    cp_adUX[l_ui] = p_obs.c_vecU[0];
+    cp_adUY[l_ui] = p_obs.c_vecU[1];
+    cp_adUZ[l_ui] = p_obs.c_vecU[2];
+    cp_adEX[l_ui] = p_obs.c_vecE[0];
+    cp_adEY[l_ui] = p_obs.c_vecE[1];
+    cp_adNX[l_ui] = p_obs.c_vecN[0];
+    cp_adNY[l_ui] = p_obs.c_vecN[1];
+    cp_adNZ[l_ui] = p_obs.c_vecN[2];
+    cp_adVX[l_ui] = p_obs.c_vecV[0];
+    cp_adVY[l_ui] = p_obs.c_vecV[1];
+    
+    return (l_ui);
+}
+
+
+void P13ObserverSet::clear() {
+    
+    cp_uiCount = 0;
+}
+
+
+uint16_t P13ObserverSet::count() {
+    
+    return (cp_uiCount);
+}
+
+
+uint16_t P13ObserverSet::capacity() {
+    
+    return (cp_uiCap);
+}
+
+
+// Elevation, azimuth (deg), range (km) and range rate (km/s) of a satellite at its last
+// prediction for all stations, each array with count() elements. Each array may be NULL.
+void P13ObserverSet::elaz(const P13Satellite &p_sat, double *p_adel, double *p_adaz, double *p_adrange, double *p_adrr) {
+    
+    elazState(p_sat.c_vecS[0], p_sat.c_vecS[1], p_sat.c_vecS[2], p_sat.c_vecV[0], p_sat.c_vecV[1], p_sat.c_vecV[2], p_adel, p_adaz, p_adrange, p_adrr);
+}
+
+
+// As above for the satellite idx of a catalog at the last P13Catalog::predict()
+void P13ObserverSet::elaz(const P13Catalog &p_cat, uint16_t p_uiidx, double *p_adel, double *p_adaz, double *p_adrange, double *p_adrr) {
+    
+    elazState(p_cat.c_adSX[p_uiidx], p_cat.c_adSY[p_uiidx], p_cat.c_adSZ[p_uiidx], p_cat.c_adVX[p_uiidx], p_cat.c_adVY[p_uiidx], p_cat.c_adVZ[p_uiidx], p_adel, p_adaz, p_adrange, p_adrr);
+}
+
+
+// As above for the moon at the last P13Moon::predict() (topocentric). The range rate
+// is not available, the moon has no velocity vector.
+void P13ObserverSet::elaz(const P13Moon &p_moon, double *p_adel, double *p_adaz, double *p_adrange) {
+    
+    elazState(p_moon.c_vecH[0] * p_moon.c_dDist, p_moon.c_vecH[1] * p_moon.c_dDist, p_moon.c_vecH[2] * p_moon.c_dDist, 0.0, 0.0, 0.0, p_adel, p_adaz, p_adrange, NULL);
+}
+
+
+// Same calculation as P13Satellite::elaz() and P13Satellite::doppler() for the geocentric
+// position S and velocity V of a satellite. The stations are independent of each other,
+// so the loop over the arrays has no dependencies and the pointer tests are loop
+// invariant; asin/atan2 are only calculated for the requested results.
+void P13ObserverSet::elazState(P13Real p_dSX, P13Real p_dSY, P13Real p_dSZ, P13Real p_dVX, P13Real p_dVY, P13Real p_dVZ, double *p_adel, double *p_adaz, double *p_adrange, double *p_adrr) {
+    
+    uint16_t l_ui;
+    P13Real  l_dRx, l_dRy, l_dRz, l_dr, l_dri;
+    P13Real  l_du, l_de, l_dn;
+    double   l_daz;
+    
+    for ( l_ui = 0; l_ui < cp_uiCount; l_ui++ )
+    {
+        // Rangevec = Satvec - Obsvec, normalised
+        l_dRx = p_dSX - cp_adOX[l_ui];
+        l_dRy = p_dSY - cp_adOY[l_ui];
+        l_dRz = p_dSZ - cp_adOZ[l_ui];
+        
+        l_dr  = sqrt(l_dRx * l_dRx + l_dRy * l_dRy + l_dRz * l_dRz);
+        l_dri = (P13Real)1.0 / l_dr;
+        
+        l_dRx *= l_dri;
+        l_dRy *= l_dri;
+        l_dRz *= l_dri;
+        
+        if ( p_adrange )
+            p_adrange[l_ui] = l_dr;
+        
+        // Range rate, Sat-Obs velocity vector along unit range vector. (VOz=obs.V[2]=0)
+        if ( p_adrr )
+            p_adrr[l_ui] = (p_dVX - cp_adVX[l_ui]) * l_dRx + (p_dVY - cp_adVY[l_ui]) * l_dRy + p_dVZ * l_dRz;
+        
+        if ( p_adel )
+        {
+            l_du = l_dRx * cp_adUX[l_ui] + l_dRy * cp_adUY[l_ui] + l_dRz * cp_adUZ[l_ui];
+            
+            p_adel[l_ui] = degrees(asin(l_du));
+        }
+        
+        if ( p_adaz )
+        {
+            l_de = l_dRx * cp_adEX[l_ui] + l_dRy * cp_adEY[l_ui];
+            l_dn = l_dRx * cp_adNX[l_ui] + l_dRy * cp_adNY[l_ui] + l_dRz * cp_adNZ[l_ui];
+            
+            l_daz = degrees(atan2(l_de, l_dn));
+            
+            if (l_daz < 0.0)
+                l_daz += 360.0;
+            
+            p_adaz[l_ui] = l_daz;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------
+//     _              ___  _ _______ _____            _           
+//  __| |__ _ ______ | _ \/ |__ /_   _| _ __ _ __| |_____ _ _ 
+// / _| / _` (_-<_-< |  _/| ||_ \ | || '_/ _` / _| / / -_) '_|
+// \__|_\__,_/__/__/ |_|  |_|___/ |_||_| \__,_\__|_\_\___|_|  
+//
+//----------------------------------------------------------------------
+
+// Tracks a satellite with a fixed time step (seconds). Every "resync" steps a full
+// predict() is done, in between the state is advanced incrementally.
+P13Tracker::P13Tracker(P13Satellite &p_sat, double p_dstep, uint16_t p_uiresync) {
+    
+    cp_psat     = &p_sat;
+    cp_dStep    = p_dstep / 86400.0;
+    cp_uiResync = p_uiresync;
+    cp_uiCount  = 0;
+}
+
+
+P13Tracker::~P13Tracker() {
+    
+}
+
+
+// Sets the start time and does a full prediction. Argument of perigee and RAAN are
+// quadratic in T (drag term KDP), so their step angle changes by a constant angle
+// every step; GHA Aries is linear in T. All three are advanced by angle addition
+// with the cos/sin of the step angles computed here.
+void P13Tracker::start(const P13DateTime &p_dt) {
+    
+    P13Satellite *l_ps = cp_psat;
+    
+    double l_dh, l_dT, l_dAP, l_dRAAN, l_dD, l_dDD;
+    
+    c_dtNow    = p_dt;
+    cp_uiCount = 0;
+    
+    l_ps->predict(p_dt);
+    
+#ifdef P13_LEAN
+    cp_dGHAE = radians(g_scdG0) + ((double)(l_ps->cp_lDE - g_sclDNG) + l_ps->cp_dTE) * g_scdWE;
+    cp_dCI   = cos(l_ps->cp_dIN);
+    cp_dSI   = sin(l_ps->cp_dIN);
+#else
+    cp_dGHAE = l_ps->cp_dGHAE;
+    cp_dCI   = l_ps->cp_dCI;
+    cp_dSI   = l_ps->cp_dSI;
+#endif
+    
+    l_dh = cp_dStep;
+    l_dT = (double)(p_dt.c_lDN - l_ps->cp_lDE) + (p_dt.c_dTN - l_ps->cp_dTE);
+    cp_dT = l_dT;
+    
+    // Argument of perigee: AP(T) = WP + WD*T - 3.5*WD*DC*T^2
+    l_dAP = l_ps->cp_dWP + l_ps->cp_dWD * l_dT * (1.0 - 3.5 * l_ps->cp_dDC * l_dT);
+    l_dD  = l_ps->cp_dWD * l_dh * (1.0 - 3.5 * l_ps->cp_dDC * (2.0 * l_dT + l_dh));
+    l_dDD = -7.0 * l_ps->cp_dWD * l_ps->cp_dDC * l_dh * l_dh;
+    
+    cp_dCW   = cos(l_dAP);  cp_dSW   = sin(l_dAP);
+    cp_dCWD  = cos(l_dD);   cp_dSWD  = sin(l_dD);
+    cp_dCWDD = cos(l_dDD);  cp_dSWDD = sin(l_dDD);
+    
+    // RAAN: RAAN(T) = RA + QD*T - 3.5*QD*DC*T^2
+    l_dRAAN = l_ps->cp_dRA + l_ps->cp_dQD * l_dT * (1.0 - 3.5 * l_ps->cp_dDC * l_dT);
+    l_dD    = l_ps->cp_dQD * l_dh * (1.0 - 3.5 * l_ps->cp_dDC * (2.0 * l_dT + l_dh));
+    l_dDD   = -7.0 * l_ps->cp_dQD * l_ps->cp_dDC * l_dh * l_dh;
+    
+    cp_dCQ   = cos(l_dRAAN); cp_dSQ   = sin(l_dRAAN);
+    cp_dCQD  = cos(l_dD);    cp_dSQD  = sin(l_dD);
+    cp_dCQDD = cos(l_dDD);   cp_dSQDD = sin(l_dDD);
+    
+    // -GHA Aries
+    cp_dCG   = cos(-(cp_dGHAE + g_scdWE * l_dT));
+    cp_dSG   = sin(-(cp_dGHAE + g_scdWE * l_dT));
+    cp_dCGD  = cos(-g_scdWE * l_dh);
+    cp_dSGD  = sin(-g_scdWE * l_dh);
+    
+    // Eccentric anomaly from the full prediction (M not reduced to 0..2PI from here on)
+    cp_dM    = l_ps->cp_dMprev;
+    cp_dMOFF = l_ps->cp_dMA + l_ps->cp_dMM * l_dT * (1.0 - 1.5 * l_ps->cp_dDC * l_dT) - cp_dM;
+    cp_dEA   = l_ps->cp_dEAprev;
+    cp_dC_EA = cos(cp_dEA);
+    cp_dS_EA = sin(cp_dEA);
+}
+
+
+// Advances the satellite state by one step. The satellite's c_vecS, c_vecV, ... are
+// updated, so latlon(), elaz() and doppler() work as after predict().
+void P13Tracker::step() {
+    
+    P13Satellite *l_ps = cp_psat;
+    
+    int      l_ii;
+    double   l_dT, l_dM, l_dd, l_dd2, l_dDNOM, l_dD;
+    P13State l_st;
+    
+    c_dtNow.add(cp_dStep);
+    
+#ifdef P13_SGP4
+    // SGP4 has no incremental form, every step is a full prediction
+    if ( l_ps->cp_uiEngine == P13_ENG_SGP4 )
+    {
+        l_ps->predict(c_dtNow);
+        return;
+    }
+#endif
+    
+    if ( ++cp_uiCount >= cp_uiResync )
+    {
+        start(c_dtNow);   // Resynchronize to bound the drift of the recurrences
+        return;
+    }
+    
+    cp_dT += cp_dStep;
+    l_dT   = cp_dT;
+    
+    fnrotate(cp_dCW,  cp_dSW,  cp_dCWD,  cp_dSWD);
+    fnrotate(cp_dCWD, cp_dSWD, cp_dCWDD, cp_dSWDD);
+    fnrotate(cp_dCQ,  cp_dSQ,  cp_dCQD,  cp_dSQD);
+    fnrotate(cp_dCQD, cp_dSQD, cp_dCQDD, cp_dSQDD);
+    fnrotate(cp_dCG,  cp_dSG,  cp_dCGD,  cp_dSGD);
+    
+    // Mean anomaly, then step EA by dM / (1 - EC*cos(EA)) with cos/sin of the small
+    // step angle from their Taylor series
+    l_dM    = l_ps->cp_dMA + l_ps->cp_dMM * l_dT * (1.0 - 1.5 * l_ps->cp_dDC * l_dT) - cp_dMOFF;
+    l_dDNOM = 1.0 - l_ps->cp_dEC * cp_dC_EA;
+    l_dd    = (l_dM - cp_dM) / l_dDNOM;
+    cp_dM   = l_dM;
+    
+    if ( fabs(l_dd) < 0.1 )
+    {
+        l_dd2   = l_dd * l_dd;
+        fnrotate(cp_dC_EA, cp_dS_EA, 1.0 - l_dd2 / 2.0 * (1.0 - l_dd2 / 12.0 * (1.0 - l_dd2 / 30.0)), l_dd * (1.0 - l_dd2 / 6.0 * (1.0 - l_dd2 / 20.0)));
+        cp_dEA += l_dd;
+    }
+    else
+    {
+        start(c_dtNow);   // Step too large for the series
+        return;
+    }
+    
+    // Newton's Method, normally one iteration with a tiny correction
+    l_ii = 0;
+    
+    do
+    {
+        l_dDNOM = 1.0 - l_ps->cp_dEC * cp_dC_EA;
+        l_dD    = (cp_dEA - l_ps->cp_dEC * cp_dS_EA - l_dM) / l_dDNOM;
+        cp_dEA -= l_dD;
+        fnrotate(cp_dC_EA, cp_dS_EA, 1.0, -l_dD);
+        l_ii++;
+    }
+    while ( (fabs(l_dD) > l_ps->cp_dKTol) && (l_ii < 4) );
+    
+    l_ps->c_ulKeplerIter += l_ii;
+    l_ps->c_ulKeplerCalls++;
+    
+    l_ps->predictState(l_st, 1.0 + 2.0 * l_ps->cp_dDC * l_dT, cp_dC_EA, cp_dS_EA, 1.0 - l_ps->cp_dEC * cp_dC_EA, cp_dCW, cp_dSW, cp_dCQ, cp_dSQ, cp_dCI, cp_dSI, cp_dCG, cp_dSG);
+    l_ps->setState(l_st);
+}
+
+
+//----------------------------------------------------------------------
+//     _              ___  _ _______                _        _____     _    _ 
+//  __| |__ _ ______ | _ \/ |__ /   \ ___ _ __ _ __| |___ _ |_   _|_ _| |__| |___ 
+// / _| / _` (_-<_-< |  _/| ||_ \ |) / _ \ '_ \ '_ \ / -_) '_|| |/ _` | '_ \ / -_) 
+// \__|_\__,_/__/__/ |_|  |_|___/___/\___/ .__/ .__/_\___|_|  |_|\__,_|_.__/_\___| 
+//                                       |_|  |_| 
+//----------------------------------------------------------------------
+
+P13DopplerTable::P13DopplerTable(float *p_afrange, float *p_afrr, uint16_t p_uimax) {
+    
+    cp_afRange = p_afrange;
+    cp_afRR    = p_afrr;
+    cp_aiRange = NULL;
+    cp_aiRR    = NULL;
+    cp_uiMax   = p_uimax;
+    cp_uiCount = 0;
+    c_dStep    = 0.0;
+    cp_dRR     = 0.0;
+}
+
+
+P13DopplerTable::P13DopplerTable(int16_t *p_airange, int16_t *p_airr, uint16_t p_uimax) {
+    
+    cp_afRange = NULL;
+    cp_afRR    = NULL;
+    cp_aiRange = p_airange;
+    cp_aiRR    = p_airr;
+    cp_uiMax   = p_uimax;
+    cp_uiCount = 0;
+    c_dStep    = 0.0;
+    cp_dRR     = 0.0;
+}
+
+
+P13DopplerTable::~P13DopplerTable() {
+    
+}
+
+
+// Predicts the satellite from time from to time to (the last entry is at or after to) with
+// step (s) and stores range and range rate for the observer. The range rate is calculated
+// from the state vectors as in P13Satellite::elaz(), the satellite is left at the last
+// entry. Returns the number of entries (limited by max), 0 if a delta is out of the 16 bit
+// range (the step is too large for the delta table).
+uint16_t P13DopplerTable::build(P13Satellite &p_sat, const P13Observer &p_obs, const P13DateTime &p_dtfrom, const P13DateTime &p_dtto, double p_dstep) {
+    
+    uint16_t    l_ui, l_uin;
+    double      l_dspan, l_dr, l_drr;
+    P13DateTime l_dt;
+    
+    Vec3 l_vecR; // Rangevec
+    
+    c_dtStart  = p_dtfrom;
+    c_dStep    = p_dstep;
+    cp_uiCount = 0;
+    
+    l_dspan = ((double)(p_dtto.c_lDN - p_dtfrom.c_lDN) + (p_dtto.c_dTN - p_dtfrom.c_dTN)) * 86400.0;
+    l_uin   = (l_dspan > 0.0) ? (uint16_t)min(ceil(l_dspan / p_dstep) + 1.0, (double)cp_uiMax) : 1;
+    l_uin   = min(l_uin, cp_uiMax);
+    
+    for ( l_ui = 0; l_ui < l_uin; l_ui++ )
+    {
+        // Each time from the start, so the steps do not accumulate rounding errors
+        l_dt = p_dtfrom;
+        l_dt.add((double)l_ui * p_dstep / 86400.0);
+        
+        p_sat.predict(l_dt);
+        
+        l_vecR[0] = p_sat.c_vecS[0] - p_obs.c_vecO[0];
+        l_vecR[1] = p_sat.c_vecS[1] - p_obs.c_vecO[1];
+        l_vecR[2] = p_sat.c_vecS[2] - p_obs.c_vecO[2];
+        
+        l_dr  = sqrt(l_vecR[0] * l_vecR[0] + l_vecR[1] * l_vecR[1] + l_vecR[2] * l_vecR[2]);
+        l_drr = ((p_sat.c_vecV[0] - p_obs.c_vecV[0]) * l_vecR[0] + (p_sat.c_vecV[1] - p_obs.c_vecV[1]) * l_vecR[1] + p_sat.c_vecV[2] * l_vecR[2]) / l_dr;
+        
+        if ( !store(l_ui, l_dr, l_drr) )
+        {
+            cp_uiCount = 0;
+            return (0);
+        }
+        
+        cp_uiCount = l_ui + 1;
+    }
+    
+    return (cp_uiCount);
+}
+
+
+// Table for a pass from AOS to LOS, see above
+uint16_t P13DopplerTable::build(P13Satellite &p_sat, const P13Observer &p_obs, const P13Pass &p_pass, double p_dstep) {
+    
+    return (build(p_sat, p_obs, p_pass.c_dtAOS, p_pass.c_dtLOS, p_dstep));
+}
+
+
+uint16_t P13DopplerTable::count() {
+    
+    return (cp_uiCount);
+}
+
+
+// Returns range (km) and range rate (km/s) of entry idx. The delta table is decoded from
+// the last requested entry, so a playback forward in time costs one addition per entry.
+void P13DopplerTable::entry(uint16_t p_uiidx, double &p_drange, double &p_drr) {
+    
+    if ( cp_afRange )
+    {
+        p_drange = cp_afRange[p_uiidx];
+        p_drr    = cp_afRR[p_uiidx];
+        return;
+    }
+    
+    if ( p_uiidx < cp_uiCur )
+    {
+        cp_uiCur     = 0;
+        cp_dCurRange = cp_dRange0;
+        cp_dCurRR    = cp_dRR0;
+    }
+    
+    while ( cp_uiCur < p_uiidx )
+    {
+        cp_uiCur++;
+        cp_dCurRange += cp_aiRange[cp_uiCur] * P13_DOP_RANGE_LSB;
+        cp_dCurRR    += cp_aiRR[cp_uiCur] * P13_DOP_RR_LSB;
+    }
+    
+    p_drange = cp_dCurRange;
+    p_drr    = cp_dCurRR;
+}
+
+
+// Interpolates range (km) and range rate (km/s) at time dt, the range by the cubic Hermite
+// polynomial with the range rates as slopes and the range rate by a cubic Hermite polynomial
+// with the slopes from the neighbouring entries (Catmull-Rom). The range rate of Plan13 is
+// not exactly the derivative of the range (the velocity does not include the drag and the
+// precession of the orbit), so both are interpolated separately to stay with the values of
+// P13Satellite::doppler(). Returns false if dt is outside of the table.
+bool P13DopplerTable::at(const P13DateTime &p_dt, double &p_drange, double &p_drr) {
+    
+    uint16_t l_ui;
+    double   l_ds, l_df, l_dh, l_dummy;
+    double   l_dr0, l_dr1, l_drrm, l_drr0, l_drr1, l_drrp;
+    double   l_dh00, l_dh10, l_dh01, l_dh11;
+    
+    if ( cp_uiCount == 0 )
+        return (false);
+    
+    l_ds = ((double)(p_dt.c_lDN - c_dtStart.c_lDN) + (p_dt.c_dTN - c_dtStart.c_dTN)) * 86400.0 / c_dStep;
+    
+    if ( (l_ds < 0.0) || (l_ds > (double)(cp_uiCount - 1)) )
+        return (false);
+    
+    if ( cp_uiCount == 1 )
+    {
+        entry(0, p_drange, p_drr);
+        cp_dRR = p_drr;
+        return (true);
+    }
+    
+    l_ui = min((uint16_t)l_ds, (uint16_t)(cp_uiCount - 2));
+    l_df = l_ds - (double)l_ui;
+    l_dh = c_dStep;
+    
+    // Entries i-1 .. i+2 in sequence for the delta table, at the ends one-sided slopes
+    if ( l_ui > 0 )
+        entry(l_ui - 1, l_dummy, l_drrm);
+    
+    entry(l_ui, l_dr0, l_drr0);
+    entry(l_ui + 1, l_dr1, l_drr1);
+    
+    if ( l_ui + 2 < cp_uiCount )
+        entry(l_ui + 2, l_dummy, l_drrp);
+    else
+        l_drrp = 2.0 * l_drr1 - l_drr0;
+    
+    if ( l_ui == 0 )
+        l_drrm = 2.0 * l_drr0 - l_drr1;
+    
+    l_dh00 =  2.0 * l_df * l_df * l_df - 3.0 * l_df * l_df + 1.0;
+    l_dh10 =        l_df * l_df * l_df - 2.0 * l_df * l_df + l_df;
+    l_dh01 = -2.0 * l_df * l_df * l_df + 3.0 * l_df * l_df;
+    l_dh11 =        l_df * l_df * l_df -       l_df * l_df;
+    
+    p_drange = l_dh00 * l_dr0 + l_dh10 * l_dh * l_drr0 + l_dh01 * l_dr1 + l_dh11 * l_dh * l_drr1;
+    p_drr    = l_dh00 * l_drr0 + l_dh10 * 0.5 * (l_drr1 - l_drrm) + l_dh01 * l_drr1 + l_dh11 * 0.5 * (l_drrp - l_drr0);
+    
+    cp_dRR = p_drr;
+    
+    return (true);
+}
+
+
+// Frequency with doppler shift at the time of the last at(), as P13Satellite::doppler()
+double P13DopplerTable::doppler(double p_dfreqMHz, bool p_bodir) {
+    
+    double l_ddopplershift = dopplerOffset(p_dfreqMHz);
+    
+    if (p_bodir)  // TX
+        return (p_dfreqMHz - l_ddopplershift);
+    
+    return (p_dfreqMHz + l_ddopplershift);    // RX
+}
+
+
+double P13DopplerTable::dopplerOffset(double p_dfreqMHz) {
+    
+    return -p_dfreqMHz * cp_dRR / 299792.0;    //  Speed of light is 299792.0 km/s
+}
+
+
+// Stores entry idx. The deltas are taken from the decoded previous entry, so the rounding
+// errors do not add up. Returns false if a delta is out of range.
+bool P13DopplerTable::store(uint16_t p_uiidx, double p_drange, double p_drr) {
+    
+    double l_dqr, l_dqrr;
+    
+    if ( cp_afRange )
+    {
+        cp_afRange[p_uiidx] = (float)p_drange;
+        cp_afRR[p_uiidx]    = (float)p_drr;
+        return (true);
+    }
+    
+    if ( p_uiidx == 0 )
+    {
+        cp_dRange0    = cp_dCurRange = p_drange;
+        cp_dRR0       = cp_dCurRR    = p_drr;
+        cp_uiCur      = 0;
+        cp_aiRange[0] = 0;
+        cp_aiRR[0]    = 0;
+        return (true);
+    }
+    
+    l_dqr  = floor((p_drange - cp_dCurRange) / P13_DOP_RANGE_LSB + 0.5);
+    l_dqrr = floor((p_drr - cp_dCurRR) / P13_DOP_RR_LSB + 0.5);
+    
+    if ( (fabs(l_dqr) > 32767.0) || (fabs(l_dqrr) > 32767.0) )
+        return (false);
+    
+    cp_aiRange[p_uiidx] = (int16_t)l_dqr;
+    cp_aiRR[p_uiidx]    = (int16_t)l_dqrr;
+    
+    cp_uiCur      = p_uiidx;
+    cp_dCurRange += l_dqr * P13_DOP_RANGE_LSB;
+    cp_dCurRR    += l_dqrr * P13_DOP_RR_LSB;
+    
+    return (true);
+}
+
+
+//----------------------------------------------------------------------
+//     _              ___  _ _______     _        _          _____     _    _ 
+//  __| |__ _ ______ | _ \/ |__ / _ \___| |_ __ _| |_ ___ _ |_   _|_ _| |__| |___ 
+// / _| / _` (_-<_-< |  _/| ||_ \   / _ \  _/ _` |  _/ _ \ '_|| |/ _` | '_ \ / -_) 
+// \__|_\__,_/__/__/ |_|  |_|___/_|_\___/\__\__,_|\__\___/_|  |_|\__,_|_.__/_\___| 
+// 
+//----------------------------------------------------------------------
+
+P13RotatorTable::P13RotatorTable(float *p_afaz, float *p_afel, uint16_t p_uimax) {
+    
+    cp_afAz    = p_afaz;
+    cp_afEl    = p_afel;
+    cp_uiMax   = p_uimax;
+    cp_uiCount = 0;
+    c_dStep    = 0.0;
+    c_uiMode   = P13_ROT_NORMAL;
+    c_dMaxErr  = 0.0;
+    
+    rotator(0.0, 360.0, 90.0);
+}
+
+
+P13RotatorTable::~P13RotatorTable() {
+    
+}
+
+
+// Sets the range of the rotator, azimuth azmin..azmax (deg, e.g. 0..360, -180..180 or
+// 0..450 for an overlap) and elevation 0..elmax (deg, 90 or 180 for flip mode), and its
+// max. rates (deg/s, 0: no limit)
+void P13RotatorTable::rotator(double p_dazmin, double p_dazmax, double p_delmax, double p_dazrate, double p_delrate) {
+    
+    cp_dAzMin  = p_dazmin;
+    cp_dAzMax  = p_dazmax;
+    cp_dElMax  = p_delmax;
+    cp_dAzRate = p_dazrate;
+    cp_dElRate = p_delrate;
+}
+
+
+// Builds the table for a pass from AOS to LOS with step (s, the last entry is at or after
+// LOS). The pass is shifted by whole turns into the middle of the azimuth range of the
+// rotator in each mode possible on the rotator. If it does not fit, the rotator either
+// waits at the stop or turns back by 360 deg at it. Both axes are limited to the rates
+// and the variant with the smallest pointing error is kept (normal mode wins a tie). The
+// satellite is predicted 3 to 15 times per entry (modes and variants) and is left at
+// entry 0. Returns the number of entries (limited by max).
+uint16_t P13RotatorTable::build(P13Satellite &p_sat, const P13Observer &p_obs, const P13Pass &p_pass, double p_dstep) {
+    
+    uint16_t l_ui, l_uin;
+    uint8_t  l_uim, l_uimodes, l_uiv, l_uibest = P13_ROT_NORMAL;
+    bool     l_bbest = false, l_blast = false;
+    double   l_dspan, l_daz, l_del, l_daz0 = 0.0, l_dprev = 0.0, l_du = 0.0, l_dlo = 0.0, l_dhi = 0.0;
+    double   l_dplane, l_dstart, l_dlom, l_dhim, l_dshift, l_dmargin, l_derr;
+    double   l_dbest = 0.0, l_dbestshift = 0.0;
+    
+    c_dtStart  = p_pass.c_dtAOS;
+    c_dStep    = p_dstep;
+    c_uiMode   = P13_ROT_NORMAL;
+    c_dMaxErr  = 0.0;
+    cp_uiCount = 0;
+    
+    l_dspan = ((double)(p_pass.c_dtLOS.c_lDN - c_dtStart.c_lDN) + (p_pass.c_dtLOS.c_dTN - c_dtStart.c_dTN)) * 86400.0;
+    l_uin   = (l_dspan > 0.0) ? (uint16_t)min(ceil(l_dspan / p_dstep) + 1.0, (double)cp_uiMax) : 1;
+    l_uin   = min(l_uin, cp_uiMax);
+    
+    if ( l_uin == 0 )
+        return (0);
+    
+    // Range of the unwrapped azimuth relative to AOS, the same for the flipped pass
+    for ( l_ui = 0; l_ui < l_uin; l_ui++ )
+    {
+        look(p_sat, p_obs, l_ui, l_daz, l_del);
+        
+        if ( l_ui == 0 )
+            l_daz0 = l_daz;
+        else
+            l_du += fnrotwrap(l_daz - l_dprev);
+        
+        l_dprev = l_daz;
+        l_dlo   = min(l_dlo, l_du);
+        l_dhi   = max(l_dhi, l_du);
+    }
+    
+    // Vertical plane between AOS and the opposite of LOS
+    l_dplane  = p_pass.c_dAzAOS + 0.5 * fnrotwrap(p_pass.c_dAzLOS + 180.0 - p_pass.c_dAzAOS);
+    l_dplane += (l_dplane < 0.0) ? 360.0 : ((l_dplane >= 360.0) ? -360.0 : 0.0);
+    
+    l_uimodes = (cp_dElMax >= 180.0) ? 3 : 1;
+    
+    for ( l_uim = 0; l_uim < l_uimodes; l_uim++ )
+    {
+        l_dstart = l_daz0;
+        l_del    = 0.0;
+        fnrotmap(l_uim, l_dplane, l_dstart, l_del);
+        
+        l_dlom    = (l_uim == P13_ROT_OVERHEAD) ? 0.0 : l_dlo;
+        l_dhim    = (l_uim == P13_ROT_OVERHEAD) ? 0.0 : l_dhi;
+        l_dshift  = 360.0 * floor((cp_dAzMin + cp_dAzMax - 2.0 * l_dstart - l_dlom - l_dhim) / 720.0 + 0.5);
+        l_dmargin = min(l_dstart + l_dshift + l_dlom - cp_dAzMin, cp_dAzMax - l_dstart - l_dshift - l_dhim);
+        
+        // Waiting at the stop (0) and, if the pass does not fit, turning back (1)
+        for ( l_uiv = 0; l_uiv < ((l_dmargin < 0.0) ? 2 : 1); l_uiv++ )
+        {
+            l_derr  = sweep(p_sat, p_obs, l_uin, l_uim, l_dplane, l_dshift, l_uiv == 1);
+            l_blast = false;
+            
+            if ( ((l_uim == 0) && (l_uiv == 0)) || (l_derr < l_dbest - 0.01) )
+            {
+                l_uibest     = l_uim;
+                l_bbest      = (l_uiv == 1);
+                l_dbestshift = l_dshift;
+                l_dbest      = l_derr;
+                l_blast      = true;
+            }
+        }
+    }
+    
+    // Table of the best variant, if it was not the last one
+    if ( !l_blast )
+        sweep(p_sat, p_obs, l_uin, l_uibest, l_dplane, l_dbestshift, l_bbest);
+    
+    c_uiMode   = l_uibest;
+    c_dMaxErr  = l_dbest;
+    cp_uiCount = l_uin;
+    
+    return (cp_uiCount);
+}
+
+
+uint16_t P13RotatorTable::count() {
+    
+    return (cp_uiCount);
+}
+
+
+// Returns azimuth and elevation (deg, in the range of the rotator) of entry idx
+void P13RotatorTable::entry(uint16_t p_uiidx, double &p_daz, double &p_del) {
+    
+    p_daz = cp_afAz[p_uiidx];
+    p_del = cp_afEl[p_uiidx];
+}
+
+
+// Interpolates azimuth and elevation (deg) at time dt linearly, as the rotator moves
+// with constant rates between the entries. Returns false if dt is outside of the table.
+bool P13RotatorTable::at(const P13DateTime &p_dt, double &p_daz, double &p_del) {
+    
+    uint16_t l_ui;
+    double   l_ds, l_df;
+    
+    if ( cp_uiCount == 0 )
+        return (false);
+    
+    l_ds = ((double)(p_dt.c_lDN - c_dtStart.c_lDN) + (p_dt.c_dTN - c_dtStart.c_dTN)) * 86400.0 / c_dStep;
+    
+    if ( (l_ds < 0.0) || (l_ds > (double)(cp_uiCount - 1)) )
+        return (false);
+    
+    if ( cp_uiCount == 1 )
+    {
+        entry(0, p_daz, p_del);
+        return (true);
+    }
+    
+    l_ui = min((uint16_t)l_ds, (uint16_t)(cp_uiCount - 2));
+    l_df = l_ds - (double)l_ui;
+    
+    p_daz = cp_afAz[l_ui] + l_df * (cp_afAz[l_ui + 1] - cp_afAz[l_ui]);
+    p_del = cp_afEl[l_ui] + l_df * (cp_afEl[l_ui + 1] - cp_afEl[l_ui]);
+    
+    return (true);
+}
+
+
+// Look angles (deg) of entry idx, each time from the start, so the steps do not
+// accumulate rounding errors
+void P13RotatorTable::look(P13Satellite &p_sat, const P13Observer &p_obs, uint16_t p_uiidx, double &p_daz, double &p_del) {
+    
+    P13DateTime l_dt;
+    
+    l_dt = c_dtStart;
+    l_dt.add((double)p_uiidx * c_dStep / 86400.0);
+    
+    p_sat.predict(l_dt);
+    p_sat.elaz(p_obs, p_del, p_daz);
+}
+
+
+// Fills the table with n entries in a mode, the unwrapped azimuth shifted by shift (deg).
+// Azimuths out of the range of the rotator are limited to it or, with unwind, turned by
+// 360 deg. Both axes
+// are limited to the rates by a forward and a backward sweep, their mean leads before and
+// lags after a fast move by the same amount. Returns the max. pointing error (deg).
+double P13RotatorTable::sweep(P13Satellite &p_sat, const P13Observer &p_obs, uint16_t p_uin, uint8_t p_uimode, double p_dplane, double p_dshift, bool p_bunwind) {
+    
+    uint16_t l_ui;
+    double   l_daz, l_del, l_dmaz, l_dmel, l_du = 0.0, l_dprev = 0.0;
+    double   l_dxaz, l_dxel, l_dsaz = 0.0, l_dsel = 0.0, l_dcos, l_derr = 0.0;
+    double   l_dazlim, l_dellim, l_delclip;
+    
+    l_dazlim  = cp_dAzRate * c_dStep;
+    l_dellim  = cp_dElRate * c_dStep;
+    l_delclip = min(cp_dElMax, 180.0);
+    
+    // Forward sweep
+    for ( l_ui = 0; l_ui < p_uin; l_ui++ )
+    {
+        look(p_sat, p_obs, l_ui, l_daz, l_del);
+        fnrotmap(p_uimode, p_dplane, l_daz, l_del);
+        
+        l_du    = (l_ui == 0) ? l_daz + p_dshift : l_du + fnrotwrap(l_daz - l_dprev);
+        l_dprev = l_daz;
+        l_dxaz  = p_bunwind ? fnrotrange(l_du, cp_dAzMin, cp_dAzMax) : constrain(l_du, cp_dAzMin, cp_dAzMax);
+        l_dxel  = constrain(l_del, 0.0, l_delclip);
+        
+        l_dsaz = (l_ui == 0) ? l_dxaz : fnrotslew(l_dsaz, l_dxaz, l_dazlim);
+        l_dsel = (l_ui == 0) ? l_dxel : fnrotslew(l_dsel, l_dxel, l_dellim);
+        
+        cp_afAz[l_ui] = (float)l_dsaz;
+        cp_afEl[l_ui] = (float)l_dsel;
+    }
+    
+    // Backward sweep from the unwrapped azimuth at the last entry, mean of both sweeps
+    // and pointing error against the look angles
+    for ( l_ui = p_uin; l_ui-- > 0; )
+    {
+        look(p_sat, p_obs, l_ui, l_daz, l_del);
+        
+        l_dmaz = l_daz;
+        l_dmel = l_del;
+        fnrotmap(p_uimode, p_dplane, l_dmaz, l_dmel);
+        
+        if ( l_ui < p_uin - 1 )
+            l_du += fnrotwrap(l_dmaz - l_dprev);
+        
+        l_dprev = l_dmaz;
+        l_dxaz  = p_bunwind ? fnrotrange(l_du, cp_dAzMin, cp_dAzMax) : constrain(l_du, cp_dAzMin, cp_dAzMax);
+        l_dxel  = constrain(l_dmel, 0.0, l_delclip);
+        
+        l_dsaz = (l_ui == p_uin - 1) ? l_dxaz : fnrotslew(l_dsaz, l_dxaz, l_dazlim);
+        l_dsel = (l_ui == p_uin - 1) ? l_dxel : fnrotslew(l_dsel, l_dxel, l_dellim);
+        
+        cp_afAz[l_ui] = (float)(0.5 * (cp_afAz[l_ui] + l_dsaz));
+        cp_afEl[l_ui] = (float)(0.5 * (cp_afEl[l_ui] + l_dsel));
+        
+        // Angle between the direction of the antenna (elevation above 90 deg points
+        // backwards) and the direction of the satellite
+        l_dcos = cos(radians(cp_afEl[l_ui])) * cos(radians(l_del)) * cos(radians(cp_afAz[l_ui] - l_daz)) + sin(radians(cp_afEl[l_ui])) * sin(radians(l_del));
+        l_derr = max(l_derr, degrees(acos(constrain(l_dcos, -1.0, 1.0))));
+    }
+    
+    return (l_derr);
+}
+
+
+//----------------------------------------------------------------------
+//     _              ___  _ _______      _                      _ 
+//  __| |__ _ ______ | _ \/ |__ / __|_ __| |_  ___ _ __  ___ _ _(_)___ 
+// / _| / _` (_-<_-< |  _/| ||_ \ _|| '_ \ ' \/ -_) '  \/ -_) '_| (_-< 
+// \__|_\__,_/__/__/ |_|  |_|___/___| .__/_||_\___|_|_|_\___|_| |_/__/ 
+//                                  |_| 
+//----------------------------------------------------------------------
+
+// The step between the nodes follows from the error of the cubic Hermite interpolation,
+// h^4 / 384 * max|x''''|, with max|x''''| = r * w^4 of the satellite at perigee, w the
+// angular rate there plus the rotation of the earth, and a margin of 2 for the terms of
+// Plan13 not in the derivative (drag). maxerr in km.
+P13Ephemeris::P13Ephemeris(P13Satellite &p_sat, Vec3 *p_avecs, Vec3 *p_avecv, uint16_t p_uinodes, double p_dmaxerr) {
+    
+    cp_psat    = &p_sat;
+    cp_avecS   = p_avecs;
+    cp_avecV   = p_avecv;
+    cp_uiNodes = p_uinodes;
+    cp_dMaxErr = p_dmaxerr;
+    c_ulNodes  = 0;
+    
+    invalidate();
+}
+
+
+P13Ephemeris::~P13Ephemeris() {
+    
+}
+
+
+// Leaves the satellite in the state at time dt as after P13Satellite::predict(), so
+// latlon(), elaz(), doppler(), footprint() and illumination() can be used as usual.
+// Slides the window first if dt is outside.
+void P13Ephemeris::predict(const P13DateTime &p_dt) {
+    
+    long    l_lk, l_lfirst, l_lk0, l_lk1;
+    int     l_ii;
+    double  l_ds, l_df, l_dh, l_dT, l_dGHAA;
+    double  l_dh00, l_dh10, l_dh01, l_dh11, l_dd00, l_dd10, l_dd01, l_dd11;
+    P13Real l_dCG, l_dSG;
+    Vec3   *l_pvecS0, *l_pvecS1, *l_pvecV0, *l_pvecV1;
+    
+    P13Satellite *l_ps = cp_psat;
+    
+    if ( !cp_bValid )
+    {
+        cp_dtBase = p_dt;
+        cp_lFirst = -(long)(cp_uiNodes / 4);
+        
+        for ( l_lk = cp_lFirst; l_lk < cp_lFirst + cp_uiNodes; l_lk++ )
+            node(l_lk);
+        
+        cp_bValid = true;
+    }
+    
+    l_ds = ((double)(p_dt.c_lDN - cp_dtBase.c_lDN) + (p_dt.c_dTN - cp_dtBase.c_dTN)) / cp_dStep;
+    l_lk = (long)floor(l_ds);
+    
+    // Slide the window (a quarter of it stays behind the time) and predict the new nodes
+    if ( (l_lk < cp_lFirst) || (l_lk + 1 > cp_lFirst + cp_uiNodes - 1) )
+    {
+        l_lfirst = l_lk - (long)(cp_uiNodes / 4);
+        
+        for ( l_lk0 = l_lfirst; l_lk0 < l_lfirst + cp_uiNodes; l_lk0++ )
+        {
+            if ( (l_lk0 < cp_lFirst) || (l_lk0 >= cp_lFirst + cp_uiNodes) )
+                node(l_lk0);
+        }
+        
+        cp_lFirst = l_lfirst;
+    }
+    
+    // Nodes are stored as ring buffer at k mod n
+    l_lk0 = l_lk % (long)cp_uiNodes;
+    
+    if ( l_lk0 < 0 )
+        l_lk0 += cp_uiNodes;
+    
+    l_lk1 = (l_lk0 + 1) % (long)cp_uiNodes;
+    
+    l_pvecS0 = &cp_avecS[l_lk0];
+    l_pvecS1 = &cp_avecS[l_lk1];
+    l_pvecV0 = &cp_avecV[l_lk0];
+    l_pvecV1 = &cp_avecV[l_lk1];
+    
+    l_df = l_ds - (double)l_lk;
+    l_dh = cp_dStep * 86400.0;
+    
+    l_dh00 =  2.0 * l_df * l_df * l_df - 3.0 * l_df * l_df + 1.0;
+    l_dh10 = (      l_df * l_df * l_df - 2.0 * l_df * l_df + l_df) * l_dh;
+    l_dh01 = -2.0 * l_df * l_df * l_df + 3.0 * l_df * l_df;
+    l_dh11 = (      l_df * l_df * l_df -       l_df * l_df) * l_dh;
+    
+    l_dd00 = (6.0 * l_df * l_df - 6.0 * l_df) / l_dh;
+    l_dd10 =  3.0 * l_df * l_df - 4.0 * l_df + 1.0;
+    l_dd01 = -l_dd00;
+    l_dd11 =  3.0 * l_df * l_df - 2.0 * l_df;
+    
+    for ( l_ii = 0; l_ii < 3; l_ii++ )
+    {
+        l_ps->c_vecS[l_ii] = l_dh00 * (*l_pvecS0)[l_ii] + l_dh10 * (*l_pvecV0)[l_ii] + l_dh01 * (*l_pvecS1)[l_ii] + l_dh11 * (*l_pvecV1)[l_ii];
+        l_ps->c_vecV[l_ii] = l_dd00 * (*l_pvecS0)[l_ii] + l_dd10 * (*l_pvecV0)[l_ii] + l_dd01 * (*l_pvecS1)[l_ii] + l_dd11 * (*l_pvecV1)[l_ii];
+    }
+    
+    // Back from the derivative of the geocentric position to the velocity of predict()
+    rates(l_ps->c_vecS, l_ps->c_vecV, l_ps->c_vecV, -1.0);
+    
+    l_ps->cp_dRS = sqrt(l_ps->c_vecS[0] * l_ps->c_vecS[0] + l_ps->c_vecS[1] * l_ps->c_vecS[1] + l_ps->c_vecS[2] * l_ps->c_vecS[2]);
+    
+    // Celestial coordinates with the GHA of Aries as in predictElapsed()
+    l_dT = (double)(p_dt.c_lDN - l_ps->cp_lDE) + (p_dt.c_dTN - l_ps->cp_dTE);
+    
+#ifdef P13_LEAN
+    l_dGHAA = radians(g_scdG0) + ((double)(l_ps->cp_lDE - g_sclDNG) + l_ps->cp_dTE) * g_scdWE + g_scdWE * l_dT;
+#else
+    l_dGHAA = l_ps->cp_dGHAE + g_scdWE * l_dT;
+#endif
+    l_dGHAA -= (long)(l_dGHAA / (2.0 * PI)) * 2.0 * PI;
+    
+    l_dCG = cos(-(P13Real)l_dGHAA);
+    l_dSG = sin(-(P13Real)l_dGHAA);
+    
+    l_ps->c_vecSAT[0] =  l_ps->c_vecS[0] * l_dCG + l_ps->c_vecS[1] * l_dSG;
+    l_ps->c_vecSAT[1] = -l_ps->c_vecS[0] * l_dSG + l_ps->c_vecS[1] * l_dCG;
+    l_ps->c_vecSAT[2] =  l_ps->c_vecS[2];
+    
+    l_ps->c_vecVEL[0] =  l_ps->c_vecV[0] * l_dCG + l_ps->c_vecV[1] * l_dSG;
+    l_ps->c_vecVEL[1] = -l_ps->c_vecV[0] * l_dSG + l_ps->c_vecV[1] * l_dCG;
+    l_ps->c_vecVEL[2] =  l_ps->c_vecV[2];
+    
+    l_ps->cp_dCG = l_dCG;
+    l_ps->cp_dSG = l_dSG;
+}
+
+
+// Returns the step between two nodes (s)
+double P13Ephemeris::step() {
+    
+    return (cp_dStep * 86400.0);
+}
+
+
+// Clears the window and calculates the step for the elements of the satellite, this has
+// to be called after new elements have been set with P13Satellite::tle().
+void P13Ephemeris::invalidate() {
+    
+    double l_dEC, l_dw, l_dr;
+    
+    l_dEC = cp_psat->cp_dEC;
+    l_dw  = cp_psat->cp_dN0 * (1.0 + l_dEC) * (1.0 + l_dEC) / pow(1.0 - l_dEC * l_dEC, 1.5) + g_scdWE / 86400.0;
+    l_dr  = cp_psat->cp_dA_0 * (1.0 - l_dEC);
+    
+    cp_dStep  = pow(384.0 * cp_dMaxErr / (2.0 * l_dr * l_dw * l_dw * l_dw * l_dw), 0.25) / 86400.0;
+    cp_bValid = false;
+}
+
+
+// Predicts node k into the ring buffer. The derivative of the geocentric position is the
+// velocity of predict() plus the rotations of the earth (W), the orbit plane (QD, around
+// the axis of the earth as W) and the perigee (WD, around the normal N of the orbit
+// plane), which are not part of the velocity.
+void P13Ephemeris::node(long p_lk) {
+    
+    long        l_lslot;
+    P13DateTime l_dt(cp_dtBase);
+    
+    l_dt.add((double)p_lk * cp_dStep);
+    cp_psat->predict(l_dt);
+    
+    l_lslot = p_lk % (long)cp_uiNodes;
+    
+    if ( l_lslot < 0 )
+        l_lslot += cp_uiNodes;
+    
+    cp_avecS[l_lslot][0] = cp_psat->c_vecS[0];
+    cp_avecS[l_lslot][1] = cp_psat->c_vecS[1];
+    cp_avecS[l_lslot][2] = cp_psat->c_vecS[2];
+    
+    rates(cp_psat->c_vecS, cp_psat->c_vecV, cp_avecV[l_lslot], 1.0);
+    
+    c_ulNodes++;
+}
+
+
+// Adds (sign 1.0) or removes (sign -1.0) the rotations of node() to/from velocity V at
+// position S. S x V is parallel to N with or without the rotation of the perigee, which
+// is along S x N.
+void P13Ephemeris::rates(const Vec3 p_vecS, const Vec3 p_vecVin, Vec3 p_vecVout, double p_dsign) {
+    
+    P13Real l_dwz, l_dwd, l_dnn;
+    
+    Vec3 l_vecV, l_vecN;
+    
+    l_dwz = (P13Real)(p_dsign * (g_scdWE - cp_psat->cp_dQD) / 86400.0);
+    l_dwd = (P13Real)(p_dsign * cp_psat->cp_dWD / 86400.0);
+    
+    // Rotation around the axis of the earth
+    l_vecV[0] = p_vecVin[0] + l_dwz * p_vecS[1];
+    l_vecV[1] = p_vecVin[1] - l_dwz * p_vecS[0];
+    l_vecV[2] = p_vecVin[2];
+    
+    // Normal of the orbit plane (from the velocity without the rotation of the earth)
+    l_vecN[0] = p_vecS[1] * (p_dsign > 0.0 ? p_vecVin[2] : l_vecV[2]) - p_vecS[2] * (p_dsign > 0.0 ? p_vecVin[1] : l_vecV[1]);
+    l_vecN[1] = p_vecS[2] * (p_dsign > 0.0 ? p_vecVin[0] : l_vecV[0]) - p_vecS[0] * (p_dsign > 0.0 ? p_vecVin[2] : l_vecV[2]);
+    l_vecN[2] = p_vecS[0] * (p_dsign > 0.0 ? p_vecVin[1] : l_vecV[1]) - p_vecS[1] * (p_dsign > 0.0 ? p_vecVin[0] : l_vecV[0]);
+    
+    l_dnn = sqrt(l_vecN[0] * l_vecN[0] + l_vecN[1] * l_vecN[1] + l_vecN[2] * l_vecN[2]);
+    
+    // Rotation of the perigee, WD * (N x S)
+    p_vecVout[0] = l_vecV[0] + l_dwd * (l_vecN[1] * p_vecS[2] - l_vecN[2] * p_vecS[1]) / l_dnn;
+    p_vecVout[1] = l_vecV[1] + l_dwd * (l_vecN[2] * p_vecS[0] - l_vecN[0] * p_vecS[2]) / l_dnn;
+    p_vecVout[2] = l_vecV[2] + l_dwd * (l_vecN[0] * p_vecS[1] - l_vecN[1] * p_vecS[0]) / l_dnn;
+}
+
+
+//----------------------------------------------------------------------
+//     _              ___  _ _______               _ _     _ 
+//  __| |__ _ ______ | _ \/ |__ / _ \__ _ _ _ __ _| | |___| | 
+// / _| / _` (_-<_-< |  _/| ||_ \  _/ _` | '_/ _` | | / -_) | 
+// \__|_\__,_/__/__/ |_|  |_|___/_| \__,_|_| \__,_|_|_\___|_| 
+// 
+//----------------------------------------------------------------------
+
+// Block of a job for one worker
+struct P13ParBlock {
+    void   (*c_pfJob)(void *p_pvjob, uint16_t p_uifirst, uint16_t p_uilast);
+    void    *c_pvJob;
+    uint16_t c_uiFirst, c_uiLast;
+#if defined(ARDUINO_ARCH_ESP32)
+    SemaphoreHandle_t c_hDone;
+#endif
+};
+
+// Parameters of the jobs
+struct P13ParJob {
+    P13Catalog         *c_pcat;
+    P13Satellite *const *c_apsat;
+    const P13Observer  *c_pobs;
+    const P13DateTime  *c_pdt;
+    P13Pass            *c_apass;
+    bool               *c_abfound;
+    double              c_dminel, c_dmaxdays;
+};
+
+
+static void fnparblock(P13ParBlock *p_pblk) {
+    
+    p_pblk->c_pfJob(p_pblk->c_pvJob, p_pblk->c_uiFirst, p_pblk->c_uiLast);
+}
+
+
+#if defined(ARDUINO_ARCH_ESP32)
+static void fnpartask(void *p_pv) {
+    
+    fnparblock((P13ParBlock *)p_pv);
+    
+    xSemaphoreGive(((P13ParBlock *)p_pv)->c_hDone);
+    vTaskDelete(NULL);
+}
+#endif
+
+
+static void fnparcatalog(void *p_pvjob, uint16_t p_uifirst, uint16_t p_uilast) {
+    
+    P13ParJob *l_pjob = (P13ParJob *)p_pvjob;
+    
+    l_pjob->c_pcat->predict(*l_pjob->c_pdt, p_uifirst, p_uilast);
+}
+
+
+static void fnparpredict(void *p_pvjob, uint16_t p_uifirst, uint16_t p_uilast) {
+    
+    P13ParJob *l_pjob = (P13ParJob *)p_pvjob;
+    uint16_t   l_ui;
+    
+    for ( l_ui = p_uifirst; l_ui < p_uilast; l_ui++ )
+        l_pjob->c_apsat[l_ui]->predict(*l_pjob->c_pdt);
+}
+
+
+static void fnparpass(void *p_pvjob, uint16_t p_uifirst, uint16_t p_uilast) {
+    
+    P13ParJob *l_pjob = (P13ParJob *)p_pvjob;
+    uint16_t   l_ui;
+    
+    for ( l_ui = p_uifirst; l_ui < p_uilast; l_ui++ )
+        l_pjob->c_abfound[l_ui] = l_pjob->c_apsat[l_ui]->nextPass(*l_pjob->c_pobs, *l_pjob->c_pdt, l_pjob->c_apass[l_ui], l_pjob->c_dminel, l_pjob->c_dmaxdays);
+}
+
+
+// Number of workers 1..P13_PAR_MAX, including the caller. Without P13_THREADS all
+// blocks are worked off by the caller, one after the other.
+P13Parallel::P13Parallel(uint8_t p_uiworkers) {
+    
+    cp_uiWorkers = constrain(p_uiworkers, 1, P13_PAR_MAX);
+}
+
+
+P13Parallel::~P13Parallel() {
+    
+}
+
+
+uint8_t P13Parallel::workers() {
+    
+    return (cp_uiWorkers);
+}
+
+
+// Predicts all satellites of the catalog for the same time as P13Catalog::predict()
+void P13Parallel::predict(P13Catalog &p_cat, const P13DateTime &p_dt) {
+    
+    P13ParJob l_job;
+    
+    l_job.c_pcat = &p_cat;
+    l_job.c_pdt  = &p_dt;
+    
+    run(fnparcatalog, &l_job, p_cat.count());
+}
+
+
+// Predicts count satellites for the same time as P13Satellite::predict(). Each satellite
+// must be in the list only once.
+void P13Parallel::predict(P13Satellite *const p_apsat[], uint16_t p_uicount, const P13DateTime &p_dt) {
+    
+    P13ParJob l_job;
+    
+    l_job.c_apsat = p_apsat;
+    l_job.c_pdt   = &p_dt;
+    
+    run(fnparpredict, &l_job, p_uicount);
+}
+
+
+// Searches the next pass of count satellites for one observer as P13Satellite::nextPass(),
+// pass[i] and found[i] for satellite i. Each satellite must be in the list only once.
+// Returns the number of satellites with a pass.
+uint16_t P13Parallel::nextPass(P13Satellite *const p_apsat[], uint16_t p_uicount, const P13Observer &p_obs, const P13DateTime &p_dtfrom, P13Pass *p_apass, bool *p_abfound, double p_dminel, double p_dmaxdays) {
+    
+    P13ParJob l_job;
+    uint16_t  l_ui, l_uin = 0;
+    
+    l_job.c_apsat    = p_apsat;
+    l_job.c_pobs     = &p_obs;
+    l_job.c_pdt      = &p_dtfrom;
+    l_job.c_apass    = p_apass;
+    l_job.c_abfound  = p_abfound;
+    l_job.c_dminel   = p_dminel;
+    l_job.c_dmaxdays = p_dmaxdays;
+    
+    run(fnparpass, &l_job, p_uicount);
+    
+    for ( l_ui = 0; l_ui < p_uicount; l_ui++ )
+        if ( p_abfound[l_ui] )
+            l_uin++;
+    
+    return (l_uin);
+}
+
+
+// Splits count items into one contiguous block per worker, block k is
+// count * k / n .. count * (k + 1) / n - 1. Block 0 is worked off by the caller. If a
+// worker can not be started, its block is worked off by the caller too. With
+// P13_PROFILE everything runs serially as the statistics are not thread safe.
+void P13Parallel::run(void (*p_pfjob)(void *p_pvjob, uint16_t p_uifirst, uint16_t p_uilast), void *p_pvjob, uint16_t p_uicount) {
+    
+    P13ParBlock l_ablk[P13_PAR_MAX];
+    uint8_t     l_uik, l_uin;
+    
+    if ( p_uicount == 0 )
+        return;
+    
+    l_uin = min((uint16_t)cp_uiWorkers, p_uicount);
+    
+    for ( l_uik = 0; l_uik < l_uin; l_uik++ )
+    {
+        l_ablk[l_uik].c_pfJob   = p_pfjob;
+        l_ablk[l_uik].c_pvJob   = p_pvjob;
+        l_ablk[l_uik].c_uiFirst = (uint16_t)((uint32_t)p_uicount * l_uik / l_uin);
+        l_ablk[l_uik].c_uiLast  = (uint16_t)((uint32_t)p_uicount * (l_uik + 1) / l_uin);
+    }
+    
+#if defined(P13_THREADS) && !defined(P13_PROFILE) && defined(ARDUINO_ARCH_ESP32)
+    SemaphoreHandle_t l_hdone;
+    uint8_t           l_uitasks = 0;
+    
+    l_hdone = xSemaphoreCreateCounting(P13_PAR_MAX, 0);
+    
+    for ( l_uik = 1; l_uik < l_uin; l_uik++ )
+    {
+        l_ablk[l_uik].c_hDone = l_hdone;
+        
+        // Workers alternate between the cores, starting with the other core than the caller
+        if ( l_hdone && (xTaskCreatePinnedToCore(fnpartask, "P13Parallel", P13_PAR_STACK, &l_ablk[l_uik], uxTaskPriorityGet(NULL), NULL, (xPortGetCoreID() + l_uik) % portNUM_PROCESSORS) == pdPASS) )
+            l_uitasks++;
+        else
+            fnparblock(&l_ablk[l_uik]);
+    }
+    
+    fnparblock(&l_ablk[0]);
+    
+    while ( l_uitasks-- )
+        xSemaphoreTake(l_hdone, portMAX_DELAY);
+    
+    if ( l_hdone )
+        vSemaphoreDelete(l_hdone);
+#elif defined(P13_THREADS) && !defined(P13_PROFILE) && !defined(ARDUINO)
+    std::thread l_athr[P13_PAR_MAX];
+    
+    for ( l_uik = 1; l_uik < l_uin; l_uik++ )
+        l_athr[l_uik] = std::thread(fnparblock, &l_ablk[l_uik]);
+    
+    fnparblock(&l_ablk[0]);
+    
+    for ( l_uik = 1; l_uik < l_uin; l_uik++ )
+        l_athr[l_uik].join();
+#else
+    for ( l_uik = 0; l_uik < l_uin; l_uik++ )
+        fnparblock(&l_ablk[l_uik]);
+#endif
+}
+
+
+//----------------------------------------------------------------------
+//     _              ___  _ _______     _           _      _ 
+//  __| |__ _ ______ | _ \/ |__ / __| __| |_  ___ __| |_  _| |___ _ _ 
+// / _| / _` (_-<_-< |  _/| ||_ \__ \/ _| ' \/ -_) _` | || | / -_) '_| 
+// \__|_\__,_/__/__/ |_|  |_|___/___/\__|_||_\___\__,_|\_,_|_\___|_| 
+// 
+//----------------------------------------------------------------------
+
+// Entry of the event heap
+struct P13SchedEntry {
+    P13DateTime c_dt;
+    uint32_t    c_ulPair;
+    uint8_t     c_uiType;
+};
+
+static const double g_scdSCHEDGAP = 60.0 / 86400.0;   // Start of the next pass search after LOS, days
+
+// Entry a is due before entry b. At the same time AOS comes before TCA before LOS, so
+// a pair never has more than 3 entries.
+static bool fnschedbefore(const P13SchedEntry &p_ena, const P13SchedEntry &p_enb) {
+    
+    if ( p_ena.c_dt.c_lDN != p_enb.c_dt.c_lDN )
+        return (p_ena.c_dt.c_lDN < p_enb.c_dt.c_lDN);
+    
+    if ( p_ena.c_dt.c_dTN != p_enb.c_dt.c_dTN )
+        return (p_ena.c_dt.c_dTN < p_enb.c_dt.c_dTN);
+    
+    return (p_ena.c_uiType < p_enb.c_uiType);
+}
+
+
+// Days from time a to time b
+static double fnschedelapsed(const P13DateTime &p_dta, const P13DateTime &p_dtb) {
+    
+    return ((double)(p_dtb.c_lDN - p_dta.c_lDN) + (p_dtb.c_dTN - p_dta.c_dTN));
+}
+
+
+// Satellites and observers are kept as pointer lists of the caller. Passes are searched
+// above minel (deg) within maxdays days from the time of the search.
+P13Scheduler::P13Scheduler(P13Satellite *const p_apsat[], uint16_t p_uisats, const P13Observer *const p_apobs[], uint16_t p_uiobs, double p_dminel, double p_dmaxdays) {
+    
+    uint32_t l_ulpairs = (uint32_t)p_uisats * p_uiobs;
+    
+    cp_apSat    = p_apsat;
+    cp_apObs    = p_apobs;
+    cp_uiSats   = p_uisats;
+    cp_uiObs    = p_uiobs;
+    cp_dMinEl   = p_dminel;
+    cp_dMaxDays = p_dmaxdays;
+    cp_pfCb     = NULL;
+    cp_pvUser   = NULL;
+    
+    cp_apass    = new P13Pass[l_ulpairs];
+    cp_abDirty  = new bool[l_ulpairs];
+    cp_aheap    = new P13SchedEntry[3 * l_ulpairs];
+    cp_ulHeap   = 0;
+    cp_bDirty   = false;
+    
+    memset(cp_abDirty, 0, l_ulpairs * sizeof(bool));
+}
+
+
+P13Scheduler::~P13Scheduler() {
+    
+    delete[] cp_apass;
+    delete[] cp_abDirty;
+    delete[] cp_aheap;
+}
+
+
+// Function called by run() for every AOS, TCA and LOS with a pointer of the
+// application
+void P13Scheduler::callback(P13EventCallback p_pfcb, void *p_pvuser) {
+    
+    cp_pfCb   = p_pfcb;
+    cp_pvUser = p_pvuser;
+}
+
+
+// Clears the queue and searches the passes of all pairs from time dt on at the next call
+void P13Scheduler::start(const P13DateTime &p_dt) {
+    
+    uint32_t l_ulpairs = (uint32_t)cp_uiSats * cp_uiObs;
+    
+    cp_dtNow  = p_dt;
+    cp_ulHeap = 0;
+    
+    memset(cp_abDirty, 1, l_ulpairs * sizeof(bool));
+    cp_bDirty = (l_ulpairs > 0);
+}
+
+
+// Drops the events of satellite sat (e.g. after P13Satellite::tle() with new elements),
+// its passes are searched again from the time of the last start() or run() at the next
+// call. An AOS in the past is delivered again for a pass in progress.
+void P13Scheduler::update(uint16_t p_uisat) {
+    
+    uint32_t l_uli, l_ulj;
+    uint16_t l_uio;
+    
+    if ( p_uisat >= cp_uiSats )
+        return;
+    
+    for ( l_uli = 0, l_ulj = 0; l_uli < cp_ulHeap; l_uli++ )
+        if ( cp_aheap[l_uli].c_ulPair / cp_uiObs != p_uisat )
+            cp_aheap[l_ulj++] = cp_aheap[l_uli];
+    
+    cp_ulHeap = l_ulj;
+    
+    for ( l_uli = cp_ulHeap / 2; l_uli > 0; l_uli-- )
+        down(l_uli - 1);
+    
+    for ( l_uio = 0; l_uio < cp_uiObs; l_uio++ )
+        cp_abDirty[(uint32_t)p_uisat * cp_uiObs + l_uio] = true;
+    
+    cp_bDirty = true;
+}
+
+
+// The next event without removing it. Returns false if the queue is empty.
+bool P13Scheduler::next(P13Event &p_ev) {
+    
+    refresh();
+    
+    if ( cp_ulHeap == 0 )
+        return (false);
+    
+    event(cp_aheap[0], p_ev);
+    
+    return (true);
+}
+
+
+// Delivers all events up to time now to the callback in the order of time and searches
+// the next passes after LOS. Returns the number of events delivered.
+uint16_t P13Scheduler::run(const P13DateTime &p_dtnow) {
+    
+    uint16_t      l_uin = 0;
+    P13SchedEntry l_en;
+    P13Event      l_ev;
+    P13DateTime   l_dt;
+    
+    cp_dtNow = p_dtnow;
+    
+    refresh();
+    
+    while ( (cp_ulHeap > 0) && (fnschedelapsed(cp_aheap[0].c_dt, p_dtnow) >= 0.0) )
+    {
+        l_en = cp_aheap[0];
+        pop();
+        
+        if ( l_en.c_uiType != P13_EV_SEARCH )
+        {
+            event(l_en, l_ev);
+            
+            if ( cp_pfCb )
+                cp_pfCb(l_ev, cp_pvUser);
+            
+            l_uin++;
+        }
+        
+        if ( (l_en.c_uiType == P13_EV_LOS) || (l_en.c_uiType == P13_EV_SEARCH) )
+        {
+            // Search from the event on or from now, if it is late (passes while the
+            // application slept are not delivered)
+            l_dt = l_en.c_dt;
+            
+            if ( l_en.c_uiType == P13_EV_LOS )
+                l_dt.add(g_scdSCHEDGAP);
+            
+            search(l_en.c_ulPair, (fnschedelapsed(l_dt, p_dtnow) > 0.0) ? p_dtnow : l_dt);
+        }
+    }
+    
+    return (l_uin);
+}
+
+
+// Seconds from time now to the next event (P13_EV_SEARCH included), 0 if it is due, as
+// hint for a sleep or deep sleep of the application until the next call of run().
+// Returns maxdays if the queue is empty.
+double P13Scheduler::sleep(const P13DateTime &p_dtnow) {
+    
+    refresh();
+    
+    if ( cp_ulHeap == 0 )
+        return (cp_dMaxDays * 86400.0);
+    
+    return (max(fnschedelapsed(p_dtnow, cp_aheap[0].c_dt), 0.0) * 86400.0);
+}
+
+
+// Searches the passes of all pairs marked by start() or update()
+void P13Scheduler::refresh() {
+    
+    uint32_t l_uli, l_ulpairs;
+    
+    if ( !cp_bDirty )
+        return;
+    
+    l_ulpairs = (uint32_t)cp_uiSats * cp_uiObs;
+    
+    for ( l_uli = 0; l_uli < l_ulpairs; l_uli++ )
+    {
+        if ( cp_abDirty[l_uli] )
+        {
+            cp_abDirty[l_uli] = false;
+            search(l_uli, cp_dtNow);
+        }
+    }
+    
+    cp_bDirty = false;
+}
+
+
+// Searches the next pass of a pair from time "from" on and queues its events, or a
+// P13_EV_SEARCH after maxdays if there is none
+void P13Scheduler::search(uint32_t p_ulpair, const P13DateTime &p_dtfrom) {
+    
+    P13Pass    &l_pass = cp_apass[p_ulpair];
+    P13DateTime l_dt(p_dtfrom);
+    
+    if ( cp_apSat[p_ulpair / cp_uiObs]->nextPass(*cp_apObs[p_ulpair % cp_uiObs], p_dtfrom, l_pass, cp_dMinEl, cp_dMaxDays) )
+    {
+        push(p_ulpair, P13_EV_AOS, l_pass.c_dtAOS);
+        push(p_ulpair, P13_EV_TCA, l_pass.c_dtTCA);
+        push(p_ulpair, P13_EV_LOS, l_pass.c_dtLOS);
+    }
+    else
+    {
+        l_dt.add(cp_dMaxDays);
+        push(p_ulpair, P13_EV_SEARCH, l_dt);
+    }
+}
+
+
+// Adds an event to the heap
+void P13Scheduler::push(uint32_t p_ulpair, uint8_t p_uitype, const P13DateTime &p_dt) {
+    
+    uint32_t      l_uli = cp_ulHeap++;
+    P13SchedEntry l_en;
+    
+    l_en.c_dt     = p_dt;
+    l_en.c_ulPair = p_ulpair;
+    l_en.c_uiType = p_uitype;
+    
+    // Sift up
+    while ( (l_uli > 0) && fnschedbefore(l_en, cp_aheap[(l_uli - 1) / 2]) )
+    {
+        cp_aheap[l_uli] = cp_aheap[(l_uli - 1) / 2];
+        l_uli = (l_uli - 1) / 2;
+    }
+    
+    cp_aheap[l_uli] = l_en;
+}
+
+
+// Removes the first event from the heap
+void P13Scheduler::pop() {
+    
+    if ( --cp_ulHeap > 0 )
+    {
+        cp_aheap[0] = cp_aheap[cp_ulHeap];
+        down(0);
+    }
+}
+
+
+// Sifts entry i down to its place in the heap
+void P13Scheduler::down(uint32_t p_uli) {
+    
+    uint32_t      l_ulc;
+    P13SchedEntry l_en = cp_aheap[p_uli];
+    
+    while ( (l_ulc = 2 * p_uli + 1) < cp_ulHeap )
+    {
+        if ( (l_ulc + 1 < cp_ulHeap) && fnschedbefore(cp_aheap[l_ulc + 1], cp_aheap[l_ulc]) )
+            l_ulc++;
+        
+        if ( !fnschedbefore(cp_aheap[l_ulc], l_en) )
+            break;
+        
+        cp_aheap[p_uli] = cp_aheap[l_ulc];
+        p_uli = l_ulc;
+    }
+    
+    cp_aheap[p_uli] = l_en;
+}
+
+
+// Event of a heap entry
+void P13Scheduler::event(const P13SchedEntry &p_en, P13Event &p_ev) {
+    
+    p_ev.c_dtTime = p_en.c_dt;
+    p_ev.c_uiType = p_en.c_uiType;
+    p_ev.c_uiSat  = p_en.c_ulPair / cp_uiObs;
+    p_ev.c_uiObs  = p_en.c_ulPair % cp_uiObs;
+    p_ev.c_ppass  = (p_en.c_uiType == P13_EV_SEARCH) ? NULL : &cp_apass[p_en.c_ulPair];
+}
+
+
+#ifdef P13_PROFILE
+
+//----------------------------------------------------------------------
+//     _              ___  _ ____ ___          __ _ _ 
+//  __| |__ _ ______ | _ \/ |__ /| _ \_ _ ___ / _(_) |___ 
+// / _| / _` (_-<_-< |  _/| ||_ \|  _/ '_/ _ \  _| | / -_) 
+// \__|_\__,_/__/__/ |_|  |_|___/|_| |_| \___/_| |_|_\___| 
+//
+//----------------------------------------------------------------------
+
+uint32_t P13Profile::c_aulCalls[P13_PROF_COUNT];
+uint32_t P13Profile::c_aulMin[P13_PROF_COUNT];
+uint32_t P13Profile::c_aulMax[P13_PROF_COUNT];
+uint64_t P13Profile::c_aullSum[P13_PROF_COUNT];
+
+static const char *g_sccaPROFNAME[P13_PROF_COUNT] = { "predict", "kepler", "elaz", "footprint", "sun", "moon" };
+
+#if defined(ARDUINO_ARCH_ESP32)
+static const char *g_sccPROFUNIT = "cycles";
+#elif defined(ARDUINO)
+static const char *g_sccPROFUNIT = "us";
+#else
+static const char *g_sccPROFUNIT = "ns";
+#endif
+
+
+// Returns the time base of the measurements (cycle counter on ESP32)
+uint32_t P13Profile::clock() {
+    
+#if defined(ARDUINO_ARCH_ESP32)
+    return (ESP.getCycleCount());
+#elif defined(ARDUINO)
+    return (micros());
+#else
+    return ((uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+
+// Adds one measurement to the statistics of the hot path id
+void P13Profile::record(uint8_t p_uiid, uint32_t p_ultime) {
+    
+    if ( (c_aulCalls[p_uiid] == 0) || (p_ultime < c_aulMin[p_uiid]) )
+        c_aulMin[p_uiid] = p_ultime;
+    
+    if ( p_ultime > c_aulMax[p_uiid] )
+        c_aulMax[p_uiid] = p_ultime;
+    
+    c_aullSum[p_uiid] += p_ultime;
+    c_aulCalls[p_uiid]++;
+}
+
+
+void P13Profile::reset() {
+    
+    uint8_t l_ui;
+    
+    for ( l_ui = 0; l_ui < P13_PROF_COUNT; l_ui++ )
+    {
+        c_aulCalls[l_ui] = c_aulMin[l_ui] = c_aulMax[l_ui] = 0;
+        c_aullSum[l_ui]  = 0;
+    }
+}
+
+
+#ifdef ARDUINO
+// Prints one line per hot path: calls, min, avg and max time per call
+void P13Profile::dump(Print &p_out) {
+    
+    uint8_t l_ui;
+    
+    for ( l_ui = 0; l_ui < P13_PROF_COUNT; l_ui++ )
+    {
+        p_out.print(g_sccaPROFNAME[l_ui]);
+        p_out.print(": calls ");
+        p_out.print(c_aulCalls[l_ui]);
+        p_out.print(" min ");
+        p_out.print(c_aulMin[l_ui]);
+        p_out.print(" avg ");
+        p_out.print(c_aulCalls[l_ui] ? (double)c_aullSum[l_ui] / (double)c_aulCalls[l_ui] : 0.0, 1);
+        p_out.print(" max ");
+        p_out.print(c_aulMax[l_ui]);
+        p_out.print(" ");
+        p_out.println(g_sccPROFUNIT);
+    }
+}
+#else
+// Prints one line per hot path: calls, min, avg and max time per call
+void P13Profile::dump(FILE *p_file) {
+    
+    uint8_t l_ui;
+    
+    for ( l_ui = 0; l_ui < P13_PROF_COUNT; l_ui++ )
+        fprintf(p_file, "%s: calls %lu min %lu avg %.1f max %lu %s\n", g_sccaPROFNAME[l_ui], (unsigned long)c_aulCalls[l_ui], (unsigned long)c_aulMin[l_ui],
+                c_aulCalls[l_ui] ? (double)c_aullSum[l_ui] / (double)c_aulCalls[l_ui] : 0.0, (unsigned long)c_aulMax[l_ui], g_sccPROFUNIT);
+}
+#endif
+
+#endif  // P13_PROFILE
@@ -1,230 +1,1031 @@
-//
-// AioP13.h
-//
-// An implementation of Plan13 in C++ by Mark VandeWettering
-//
-// Plan13 is an algorithm for satellite orbit prediction first formulated
-// by James Miller G3RUH.  I learned about it when I saw it was the basis 
-// of the PIC based antenna rotator project designed by G6LVB.
-//
-// http://www.g6lvb.com/Articles/LVBTracker2/index.htm
-//
-// I ported the algorithm to Python, and it was my primary means of orbit
-// prediction for a couple of years while I operated the "Easy Sats" with 
-// a dual band hand held and an Arrow antenna.
-//
-// I've long wanted to redo the work in C++ so that I could port the code
-// to smaller processors including the Atmel AVR chips.  Bruce Robertson,
-// VE9QRP started the qrpTracker project to fufill many of the same goals,
-// but I thought that the code could be made more compact and more modular,
-// and could serve not just the embedded targets but could be of more
-// use for more general applications.  And, I like the BSD License a bit
-// better too.
-//
-// So, here it is!
-//
-// =====================================================================
-//
-// dl9sec@gmx.net (02..11/2021):
-//
-// The original Plan13 BBC Basic source code can be found at:
-//
-// https://www.amsat.org/articles/g3ruh/111.html
-//
-// Published as "Donationware" in favour of AMSAT-UK, LONDON, E12 5EQ
-// and the AO-13 Amateur Satellite Program.
-//
-// Changes:
-// - Refactoring for seamless use with Arduino.
-// - Renamed class DateTime to P13DateTime because of potential conflict
-//   with RTClib, which uses the same class name.
-// - Renamed all classes to P13... for consistency and clarification of
-//   affiliation.
-// - Some code beautification.
-// - Changed output of method "ascii" to ISO date format
-// - Added helper function for converting lat/lon coordinates to rectangular
-//   map coordinates
-// - Used all double
-// - Used PI instead of M_PI
-// - Used degrees() and radians() instead of DEGREES() and RADIANS()
-// - Inserted explicit casts
-// - Added a method "footprint" to class P13Satellite
-// - Added a method "doppler" to calculate down- and uplink frequencies
-// - Added a method "footprint" to class P13Sun
-// - Renamed the whole stuff from ArduinoP13 to AioP13 to follow the
-//   Arduino library specifications for naming of libraries.
-// - Rework of all the variable names because of conflicts.
-//   All variables got a qualifier to get more or less unique names:
-//   "g_": global variables
-//   "c_": class public variables
-//   "cp_": class private variables
-//   "p_": parameter variable
-//   "l_": local variable
-//   The next letter gives a hint about the data type (e.g. "d": double,
-//   "i": integer, "cc": constant character, "vec": Vec3 vector, ...).
-//   In some cases this is very ugly, so all the variables should be renamed
-//   to speaking and useful names in one of the next releases.
-//
-//----------------------------------------------------------------------
-
-#ifndef AioP13_H
-#define AioP13_H
-
-#if defined(ARDUINO) && ARDUINO >= 100
-  #include "Arduino.h"
-#else
-  #include "WProgram.h"
-#endif
-
-#define P13_FRX 0
-#define P13_FTX 1
-
-void latlon2xy(int &p_ix, int &l_iy, double p_dlat, double p_dlon, const int p_ciMapMaxX, const int p_ciMapMaxY);
-
-//----------------------------------------------------------------------
-
-// here are a bunch of constants that will be used throughout the 
-// code, but which will probably not be helpful outside.
-
-static const double g_scdRE   = 6378.137;                   // WGS-84 Earth ellipsoid
-static const double g_scdFL   = 1.0 / 298.257224;           // -"-
-static const double g_scdRP   = g_scdRE * (1.0 - g_scdFL);  // -
-
-static const double g_scdGM   = 3.986E5;                    // Earth's Gravitational constant km^3/s^2
-static const double g_scdJ2   = 1.08263E-3;                 // 2nd Zonal coeff, Earth's Gravity Field
-
-static const double g_scdYM   = 365.25;                     // Mean Year,     days
-static const double g_scdYT   = 365.2421896698;             // Tropical year, days
-static const double g_scdWW   = 2.0 * PI / g_scdYT;         // Earth's rotation rate, rads/whole day
-static const double g_scdWE   = 2.0 * PI + g_scdWW;         // Earth's rotation rate, radians/day 
-static const double g_scdW0   = g_scdWE / 86400.0;          // Earth's rotation rate, radians/sec
-
-// Sidereal and Solar data. Rarely needs changing. Valid to year ~2030
-static const double g_scdYG   = 2014.0;                     // GHAA, Year YG, Jan 0.0
-static const double g_scdG0   = 99.5828;                    // -"-
-static const double g_scdMAS0 = 356.4105;                   // MA Sun and rate, deg, deg/day
-static const double g_scdMASD = 0.98560028;                 // -"-
-static const double g_scdINS  = radians(23.4375);           // Sun's inclination
-static const double g_scdCNS  = cos(g_scdINS);              // -"-
-static const double g_scdSNS  = sin(g_scdINS);              // -"-
-static const double g_scdEQC1 = 0.03340;                    // Sun's Equation of centre terms
-static const double g_scdEQC2 = 0.00035;                    // -"-
-
-static const double g_scdAU   = 149.597870700E6;            // 1 AU, mean range in km to the sun
-
-//----------------------------------------------------------------------
-
-// The original BASIC code used three variables (e.g. Ox, Oy, Oz) to
-// represent a vector quantity.  I think that makes for slightly more
-// obtuse code, so I going to collapse them into a single variable 
-// which is an array of three elements.
-
-typedef double Vec3[3];
-
-//----------------------------------------------------------------------
-
-class P13DateTime {
-
-public:
-    const static uint8_t ascii_str_len = 19;
-
-    long   c_lDN;
-    double c_dTN;
-    
-    P13DateTime();
-    P13DateTime(const P13DateTime &p_dt);
-    P13DateTime(int p_iyear, int p_imonth, int p_iday, int p_ih, int p_im, int p_is);
-    ~P13DateTime();
-    
-    void add(double p_ddays);
-    void settime(int p_iyear, int p_imonth, int p_iday, int p_ih, int p_im, int p_is);
-    void gettime(int &p_iyear, int &p_imon, int &p_iday, int &p_ih, int &p_im, int &p_is);
-    void ascii(char *p_cbuf);
-    void roundup(double p_dtime);
-};
-
-
-//----------------------------------------------------------------------
-
-class P13Observer {
-
-public:
-    char *c_ccObsName;
-    double c_dLA;
-    double c_dLO;
-    double c_dHT;
-    
-    Vec3 c_vecU, c_vecE, c_vecN, c_vecO, c_vecV;
-    
-    P13Observer(const char *p_ccnm, double p_dlat, double p_dlon, double p_dasl);
-    ~P13Observer();
-};
-
-
-//----------------------------------------------------------------------
-
-class P13Satellite { 
-
-public:
-    char *c_ccSatName;
-    
-    Vec3 c_vecSAT, c_vecVEL;      // Celestial coordinates
-    Vec3 c_vecS, c_vecV;          // Geocentric coordinates
- 
-    P13Satellite(const char *p_ccSatName, const char *p_ccl1, const char *p_ccl2);
-    ~P13Satellite();
-    
-    void   tle(const char *p_ccSatName, const char *p_ccl1, const char *p_ccl2);
-    void   predict(const P13DateTime &p_dt);
-    void   latlon(double &p_dlat, double &p_dlon);
-    void   elaz(const P13Observer &p_obs, double &p_del, double &p_daz);
-    void   footprint(int p_aipoints[][2], int p_inumberofpoints, const int p_ciMapMaxX, const int p_ciMapMaxY, double &p_dsatlat, double &p_dsatlon);
-    double doppler(double p_dfreqMHz, bool p_bodir);
-    double dopplerOffset(double p_dfreqMHz);
-
-private:
-    long   cp_lN;       // Satellite calaog number
-    long   cp_lYE;      // Epoch Year               year
-    double cp_dTE;      // Epoch time               days
-    double cp_dIN;      // Inclination              deg
-    double cp_dRA;      // R.A.A.N.                 deg
-    double cp_dEC;      // Eccentricity              -
-    double cp_dWP;      // Arg perigee              deg
-    double cp_dMA;      // Mean anomaly             deg
-    double cp_dMM;      // Mean motion              rev/d
-    double cp_dM2;      // Decay Rate               rev/d/d
-    double cp_dRV;      // Orbit number              -
-//    double cp_dALON;    // Sat attitude             deg
-//    double cp_dALAT;    // Sat attitude             deg
-    long   cp_lDE;      // Epoch Fraction of day
-    
-    // These values are stored, but could be calculated on the fly during calls to predict() 
-    // Classic space/time tradeoff
-
-    double cp_dN0, cp_dA_0, cp_dB_0;
-    double cp_dPC;
-    double cp_dQD, cp_dWD, cp_dDC;
-
-    double cp_dRS;      // Radius of satellite orbit
-    double cp_dRR;      // Range rate for doppler calculation
-
-};
-
-
-//----------------------------------------------------------------------
-
-class P13Sun {
-
-public:
-    Vec3 c_vecSUN, c_vecH;
-    
-    P13Sun();
-    ~P13Sun();
-    
-    void predict(const P13DateTime &p_dt);
-    void latlon(double &p_dlat, double &p_dlon);
-    void elaz(const P13Observer &p_obs, double &p_del, double &p_daz);
-    void footprint(int p_aipoints[][2], int p_inumberofpoints, const int p_ciMapMaxX, const int p_ciMapMaxY, double &p_dsunlat, double &p_dsunlon);
-};
-
+//
+// AioP13.h
+//
+// An implementation of Plan13 in C++ by Mark VandeWettering
+//
+// Plan13 is an algorithm for satellite orbit prediction first formulated
+// by James Miller G3RUH.  I learned about it when I saw it was the basis 
+// of the PIC based antenna rotator project designed by G6LVB.
+//
+// http://www.g6lvb.com/Articles/LVBTracker2/index.htm
+//
+// I ported the algorithm to Python, and it was my primary means of orbit
+// prediction for a couple of years while I operated the "Easy Sats" with 
+// a dual band hand held and an Arrow antenna.
+//
+// I've long wanted to redo the work in C++ so that I could port the code
+// to smaller processors including the Atmel AVR chips.  Bruce Robertson,
+// VE9QRP started the qrpTracker project to fufill many of the same goals,
+// but I thought that the code could be made more compact and more modular,
+// and could serve not just the embedded targets but could be of more
+// use for more general applications.  And, I like the BSD License a bit
+// better too.
+//
+// So, here it is!
+//
+// =====================================================================
+//
+// dl9sec@gmx.net (02..11/2021):
+//
+// The original Plan13 BBC Basic source code can be found at:
+//
+// https://www.amsat.org/articles/g3ruh/111.html
+//
+// Published as "Donationware" in favour of AMSAT-UK, LONDON, E12 5EQ
+// and the AO-13 Amateur Satellite Program.
+//
+// Changes:
+// - Refactoring for seamless use with Arduino.
+// - Renamed class DateTime to P13DateTime because of potential conflict
+//   with RTClib, which uses the same class name.
+// - Renamed all classes to P13... for consistency and clarification of
+//   affiliation.
+// - Some code beautification.
+// - Changed output of method "ascii" to ISO date format
+// - Added helper function for converting lat/lon coordinates to rectangular
+//   map coordinates
+// - Used all double (see P13Real for single precision)
+// - Used PI instead of M_PI
+// - Used degrees() and radians() instead of DEGREES() and RADIANS()
+// - Inserted explicit casts
+// - Added a method "footprint" to class P13Satellite
+// - Added a method "doppler" to calculate down- and uplink frequencies
+// - Added a method "footprint" to class P13Sun
+// - Renamed the whole stuff from ArduinoP13 to AioP13 to follow the
+//   Arduino library specifications for naming of libraries.
+// - Rework of all the variable names because of conflicts.
+//   All variables got a qualifier to get more or less unique names:
+//   "g_": global variables
+//   "c_": class public variables
+//   "cp_": class private variables
+//   "p_": parameter variable
+//   "l_": local variable
+//   The next letter gives a hint about the data type (e.g. "d": double,
+//   "i": integer, "cc": constant character, "vec": Vec3 vector, ...).
+//   In some cases this is very ugly, so all the variables should be renamed
+//   to speaking and useful names in one of the next releases.
+//
+//----------------------------------------------------------------------
+
+#ifndef AioP13_H
+#define AioP13_H
+
+#if defined(ARDUINO) && ARDUINO >= 100
+  #include "Arduino.h"
+#elif defined(ARDUINO)
+  #include "WProgram.h"
+#else
+  // Host build (e.g. the benchmark example on a PC): just the few definitions
+  // of the Arduino core used by the library
+  #include <math.h>
+  #include <stdint.h>
+  #include <stddef.h>
+  #include <stdio.h>
+  #include <string.h>
+  #include <algorithm>
+  using std::max;
+  using std::min;
+  #ifndef PI
+    #define PI 3.1415926535897932384626433832795
+  #endif
+  #define DEG_TO_RAD 0.017453292519943295769236907684886
+  #define RAD_TO_DEG 57.295779513082320876798154814105
+  #define radians(deg) ((deg)*DEG_TO_RAD)
+  #define degrees(rad) ((rad)*RAD_TO_DEG)
+  #define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+  #define PROGMEM
+  #define memcpy_P memcpy
+#endif
+
+#define P13_FRX 0
+#define P13_FTX 1
+
+// Flags of P13Satellite::illumination()
+#define P13_ILL_SUNLIT   0x01   // Satellite in sunlight (not in the shadow of the earth)
+#define P13_ILL_DARK     0x02   // Sun at the observer below the twilight elevation
+#define P13_ILL_ABOVE    0x04   // Satellite above the minimum elevation
+#define P13_ILL_VISIBLE  (P13_ILL_SUNLIT | P13_ILL_DARK | P13_ILL_ABOVE)  // Visible to the eye
+
+#define P13_TWILIGHT     -6.0           // Sun elevation for the observer in darkness (civil twilight), deg
+#define P13_SUN_MAXAGE   (1.0 / 24.0)   // Max. age of the sun vector for P13Sun::refresh(), days
+
+// Engines of P13Sun
+#define P13_SUN_PLAN13   0   // Plan13 model with the fixed epoch YG, valid to ~2030 (default)
+#define P13_SUN_MEEUS    1   // Low precision solar coordinates of Meeus with GMST, ~0.01 deg
+
+// Engines of P13Satellite
+#define P13_ENG_PLAN13   0   // Plan13 model with J2 secular terms and linear drag (default, fast)
+#define P13_ENG_SGP4     1   // SGP4 model of Spacetrack Report #3 for orbits below 225 min
+
+// P13Satellite caches the epoch constants (GHA of Aries at epoch, cos/sin of the
+// inclination) per TLE to save time in predict(). Define P13_LEAN to calculate them
+// on every call instead and save the RAM. P13_LEAN is the default for AVR, define
+// P13_FAST to force the cache there too. As the class layout changes, the define
+// has to be a global compiler flag (e.g. build_flags in PlatformIO).
+#if defined(__AVR__) && !defined(P13_FAST) && !defined(P13_LEAN)
+  #define P13_LEAN
+#endif
+
+// The SGP4 engine of P13Satellite (see P13Satellite::engine()) keeps about 270 bytes of
+// constants per satellite. It is left out on AVR, where double is 32 bit anyway, unless
+// P13_SGP4 is defined; define P13_NO_SGP4 to leave it out on other targets. Like
+// P13_LEAN it has to be a global compiler flag.
+#if !defined(__AVR__) && !defined(P13_NO_SGP4) && !defined(P13_SGP4)
+  #define P13_SGP4
+#endif
+
+// All orbit calculations use the scalar type P13Real, which is double by default.
+// Define P13_FLOAT to calculate in single precision on targets with a single
+// precision FPU only (e.g. Cortex-M4F), where double is emulated in software. Day
+// numbers, elapsed times and angles growing with time (mean anomaly, GHA of Aries)
+// are always calculated in double and reduced to 0..2PI before they are converted
+// to P13Real. The README lists the resulting accuracy. On AVR double is 32 bit
+// anyway. Like P13_LEAN, P13_FLOAT has to be a global compiler flag.
+#ifdef P13_FLOAT
+typedef float P13Real;
+#else
+typedef double P13Real;
+#endif
+
+#define P13_NAME_LEN 24   // Max. length of satellite names in a catalog (TLE line 0)
+
+// P13Observer and P13Satellite keep their names in a buffer on the heap with the length
+// of the name, which is reused by P13Satellite::tle() if the new name fits. Define
+// P13_NAME_INLINE to store the names in the objects instead (P13_NAME_LEN characters,
+// longer names are truncated), so they never allocate and can live in static memory.
+// As the class layout changes, it has to be a global compiler flag like P13_LEAN.
+
+#define P13_TLE_OK        0   // TLE parsed
+#define P13_TLE_EFORMAT   1   // TLE lines have a wrong length or layout
+#define P13_TLE_ECHECKSUM 2   // TLE lines have a wrong checksum
+
+#define P13_TLE_LINE_MAX  80  // Line buffer size for loading TLE files from a stream
+
+// Binary element record of P13Satellite::save()/load() and P13Catalog::loadRecords()
+// with the parsed elements and the constants derived from them, so no TLE has to be
+// parsed at boot. The layout is fixed (little endian, independent of P13_FLOAT,
+// P13_LEAN and the size of double on the target):
+//   0..159    TE, IN, RA, EC, WP, MA, MM, M2, RV, BS, N0, A_0, B_0, PC, QD, WD, DC,
+//             GHAE, CI, SI as IEEE 754 binary64 (as calculated from the TLE)
+//   160..171  Catalog number, epoch year and epoch day number as int32
+//   172..195  Name, padded with zeros (not terminated if it has 24 characters)
+//   196..199  'P', 'R', P13_REC_VERSION and the sum of the bytes 0..198 (mod 256)
+// The host tool extras/tle2bin converts TLE files to a file or a C array of records.
+#define P13_REC_SIZE      200
+#define P13_REC_VERSION   1
+
+// P13Parallel runs its workers as FreeRTOS tasks on ESP32. On a host define
+// P13_THREADS to use std::thread (link with -pthread), without it (and on all other
+// boards) the work is done serially by the caller.
+#if defined(ARDUINO_ARCH_ESP32) && !defined(P13_THREADS)
+  #define P13_THREADS
+#endif
+
+#define P13_PAR_MAX       8       // Max. number of workers of P13Parallel
+#define P13_PAR_STACK     4096    // Stack size of the worker tasks on ESP32, bytes
+
+// Define P13_PROFILE to measure the hot paths of the library (call count and
+// min/avg/max time per call, see P13Profile). Without it the hooks compile to
+// nothing. Has to be a global compiler flag like P13_LEAN.
+#ifdef P13_PROFILE
+  #define P13_PROF_PREDICT    0   // P13Satellite predictions (predict, predictBatch, nextPass)
+  #define P13_PROF_KEPLER     1   // Solution of Kepler's equation in the predictions
+  #define P13_PROF_ELAZ       2   // P13Satellite::elaz()
+  #define P13_PROF_FOOTPRINT  3   // Footprint outlines as map (all footprints, P13Footprint::map())
+  #define P13_PROF_SUN        4   // P13Sun::predict()
+  #define P13_PROF_MOON       5   // P13Moon::predict()
+  #define P13_PROF_COUNT      6
+
+  #define P13_PROF_BEGIN(id)  uint32_t l_ulProf##id = P13Profile::clock()
+  #define P13_PROF_END(id)    P13Profile::record(id, P13Profile::clock() - l_ulProf##id)
+#else
+  #define P13_PROF_BEGIN(id)
+  #define P13_PROF_END(id)
+#endif
+
+void latlon2xy(int &p_ix, int &l_iy, double p_dlat, double p_dlon, const int p_ciMapMaxX, const int p_ciMapMaxY);
+
+//----------------------------------------------------------------------
+
+// here are a bunch of constants that will be used throughout the 
+// code, but which will probably not be helpful outside.
+
+static const double g_scdRE   = 6378.137;                   // WGS-84 Earth ellipsoid
+static const double g_scdFL   = 1.0 / 298.257224;           // -"-
+static const double g_scdRP   = g_scdRE * (1.0 - g_scdFL);  // -
+
+static const double g_scdGM   = 3.986E5;                    // Earth's Gravitational constant km^3/s^2
+static const double g_scdJ2   = 1.08263E-3;                 // 2nd Zonal coeff, Earth's Gravity Field
+
+static const double g_scdYM   = 365.25;                     // Mean Year,     days
+static const long   g_sclJ2K  = 730135L;                    // Day number of 2000 Jan 01 (J2000.0 = 12h UT)
+static const long   g_sclUNIX = 719178L;                    // Day number of 1970 Jan 01 (Unix epoch)
+static const double g_scdYT   = 365.2421896698;             // Tropical year, days
+static const double g_scdWW   = 2.0 * PI / g_scdYT;         // Earth's rotation rate, rads/whole day
+static const double g_scdWE   = 2.0 * PI + g_scdWW;         // Earth's rotation rate, radians/day 
+static const double g_scdW0   = g_scdWE / 86400.0;          // Earth's rotation rate, radians/sec
+
+// Sidereal and Solar data. Rarely needs changing. Valid to year ~2030. The derived
+// values are precalculated literals, so the constants need no initialization at run
+// time on any toolchain; change them together with YG and INS.
+static const double g_scdYG   = 2014.0;                     // GHAA, Year YG, Jan 0.0
+static const double g_scdG0   = 99.5828;                    // -"-
+static const long   g_sclDNG  = 735248L;                    // -"-, day number of YG Jan 0.0
+static const double g_scdMAS0 = 356.4105;                   // MA Sun and rate, deg, deg/day
+static const double g_scdMASD = 0.98560028;                 // -"-
+static const double g_scdINS  = 0.40906154343617096;        // Sun's inclination, radians(23.4375)
+static const double g_scdCNS  = 0.91749449644749137;        // -"-, cos(INS)
+static const double g_scdSNS  = 0.39774847452701101;        // -"-, sin(INS)
+static const double g_scdEQC1 = 0.03340;                    // Sun's Equation of centre terms
+static const double g_scdEQC2 = 0.00035;                    // -"-
+
+static const double g_scdAU   = 149.597870700E6;            // 1 AU, mean range in km to the sun
+
+//----------------------------------------------------------------------
+
+// The original BASIC code used three variables (e.g. Ox, Oy, Oz) to
+// represent a vector quantity.  I think that makes for slightly more
+// obtuse code, so I going to collapse them into a single variable 
+// which is an array of three elements.
+
+typedef P13Real Vec3[3];
+
+//----------------------------------------------------------------------
+
+class P13DateTime {
+
+public:
+    const static uint8_t ascii_str_len = 19;
+
+    long   c_lDN;
+    double c_dTN;
+    
+    P13DateTime();
+    P13DateTime(const P13DateTime &p_dt);
+    P13DateTime(int p_iyear, int p_imonth, int p_iday, int p_ih, int p_im, int p_is);
+    ~P13DateTime();
+    
+    P13DateTime &operator=(const P13DateTime &p_dt);
+    
+    void add(double p_ddays);
+    void settime(int p_iyear, int p_imonth, int p_iday, int p_ih, int p_im, int p_is);
+    void settime(const P13DateTime &p_dtbase, uint32_t p_ulms);
+    void setunix(uint32_t p_ulsec, double p_dfrac = 0.0);
+    void gettime(int &p_iyear, int &p_imon, int &p_iday, int &p_ih, int &p_im, int &p_is);
+    uint32_t getunix();
+    void ascii(char *p_cbuf);
+    void roundup(double p_dtime);
+};
+
+
+//----------------------------------------------------------------------
+
+class P13Observer {
+
+public:
+#ifdef P13_NAME_INLINE
+    char c_ccObsName[P13_NAME_LEN + 1];
+#else
+    char *c_ccObsName;
+#endif
+    P13Real c_dLA;
+    P13Real c_dLO;
+    P13Real c_dHT;
+    
+    Vec3 c_vecU, c_vecE, c_vecN, c_vecO, c_vecV;
+    
+    P13Observer(const char *p_ccnm, double p_dlat, double p_dlon, double p_dasl);
+    P13Observer(const P13Observer &p_obs);
+    ~P13Observer();
+    
+    P13Observer &operator=(const P13Observer &p_obs);
+#ifndef P13_NAME_INLINE
+    P13Observer(P13Observer &&p_obs);
+    P13Observer &operator=(P13Observer &&p_obs);
+#endif
+
+private:
+    void copy(const P13Observer &p_obs);
+};
+
+
+//----------------------------------------------------------------------
+
+// Result of a pass search: acquisition of signal (AOS), time of closest
+// approach (TCA, maximum elevation) and loss of signal (LOS).
+
+class P13Pass {
+
+public:
+    P13DateTime c_dtAOS, c_dtTCA, c_dtLOS;
+    double c_dAzAOS, c_dAzTCA, c_dAzLOS;
+    double c_dMaxEL;
+};
+
+
+//----------------------------------------------------------------------
+
+// State of a satellite from P13Satellite::propagate() and the look angles of an
+// observer from P13Satellite::look(). Both are returned by value, so one satellite
+// can be used by several tasks or threads at the same time.
+
+class P13State {
+
+public:
+    Vec3    c_vecSAT, c_vecVEL;   // Celestial coordinates
+    Vec3    c_vecS, c_vecV;       // Geocentric coordinates
+    P13Real c_dRS;                // Radius of satellite orbit
+    P13Real c_dCG, c_dSG;         // cos/sin of -GHA Aries
+};
+
+class P13Look {
+
+public:
+    double c_dEL, c_dAZ;          // Elevation, azimuth, deg
+    double c_dRange;              // Range, km
+    double c_dRR;                 // Range rate, km/s
+};
+
+
+//----------------------------------------------------------------------
+
+// Footprint outlines from a cached unit circle. The cos/sin of the angles around
+// the circle are calculated once into a buffer of the caller (circle[n][2]) and
+// reused for every footprint with n points, so a point costs a few multiplications,
+// asin() and atan2() instead of a rotation with sin/cos. Without a buffer (NULL)
+// the circle is generated by angle addition while the points are calculated.
+// This kernel is shared by all footprints (satellites, catalogs and the sun).
+
+#define P13_PROJ_EQUIRECT   0   // Equirectangular map as latlon2xy()
+#define P13_PROJ_AZIMUTHAL  1   // Azimuthal equidistant map around a center (e.g. the QTH or a pole)
+
+class P13Satellite;
+class P13Catalog;
+class P13Sun;
+class P13Moon;
+
+struct P13Elements;
+
+class P13Footprint {
+
+public:
+    P13Footprint(P13Real p_adcircle[][2], int p_inumberofpoints);
+    ~P13Footprint();
+    
+    int  points();
+    void projection(uint8_t p_uiproj, double p_dlat = 90.0, double p_dlon = 0.0);
+    void project(int &p_ix, int &p_iy, double p_dlat, double p_dlon, const int p_ciMapMaxX, const int p_ciMapMaxY);
+    void latlon(double p_dradius, double p_dlat, double p_dlon, float *p_aflat, float *p_aflon);
+    void map(double p_dradius, double p_dlat, double p_dlon, int p_aipoints[][2], const int p_ciMapMaxX, const int p_ciMapMaxY, uint8_t *p_aubreak = NULL);
+    int  map(P13Satellite *const p_apsat[], int p_icount, int p_aipoints[][2], const int p_ciMapMaxX, const int p_ciMapMaxY, uint8_t *p_aubreak = NULL);
+    int  map(P13Catalog &p_cat, int p_aipoints[][2], const int p_ciMapMaxX, const int p_ciMapMaxY, uint8_t *p_aubreak = NULL);
+
+private:
+    P13Real (*cp_adCircle)[2];   // cos/sin of the angles around the circle
+    int      cp_iPoints;
+    double   cp_dCD, cp_dSD;     // cos/sin of the angle between two points (without buffer)
+    double   cp_dCC, cp_dSC;     // cos/sin of the current point (without buffer)
+    
+    P13Real  cp_dA, cp_dB, cp_dC, cp_dD, cp_dSR;   // Terms of the current center and radius
+    P13Real  cp_dLO, cp_dCLO, cp_dSLO;            // -"-
+    
+    uint8_t  cp_uiProj;                           // Projection and its center
+    P13Real  cp_dCLA0, cp_dSLA0, cp_dCLO0, cp_dSLO0;
+    
+    void center(double p_dradius, double p_dlat, double p_dlon);
+    void point(int p_ii, P13Real &p_dx, P13Real &p_dy, P13Real &p_dz);
+    P13Real pointlon(P13Real p_dx, P13Real p_dy);
+    void azimuthal(int &p_ix, int &p_iy, P13Real p_dX, P13Real p_dY, P13Real p_dZ, const int p_ciMapMaxX, const int p_ciMapMaxY);
+};
+
+
+//----------------------------------------------------------------------
+
+#ifdef P13_SGP4
+// Mean elements of a TLE for SGP4 and the constants of the near earth model derived
+// from them (names after the reference implementation of D. Vallado, "Revisiting
+// Spacetrack Report #3", 2006), see P13Satellite::engine()
+
+struct P13Sgp4 {
+    double c_dBS;                                  // B* drag term, 1/earth radii
+    double c_dEC, c_dIN, c_dRA, c_dWP, c_dMA;      // Elements, rad
+    double c_dNO;                                  // Mean motion (Brouwer), rad/min
+    double c_dCOSIO, c_dSINIO, c_dCON41, c_dX1MTH2, c_dX7THM1;
+    double c_dMDOT, c_dARGPDOT, c_dNODEDOT, c_dNODECF;
+    double c_dCC1, c_dCC4, c_dCC5, c_dD2, c_dD3, c_dD4;
+    double c_dT2COF, c_dT3COF, c_dT4COF, c_dT5COF;
+    double c_dETA, c_dDELMO, c_dSINMAO, c_dOMGCOF, c_dXMCOF, c_dXLCOF, c_dAYCOF;
+    bool   c_bSimple;                              // Perigee below 220 km, drag terms to t^2 only
+};
+#endif
+
+
+//----------------------------------------------------------------------
+
+class P13Satellite { 
+
+    friend class P13Catalog;
+    friend class P13Tracker;
+    friend class P13Ephemeris;
+
+public:
+#ifdef P13_NAME_INLINE
+    char c_ccSatName[P13_NAME_LEN + 1];
+#else
+    char *c_ccSatName;
+#endif
+    
+    unsigned long c_ulKeplerCalls;   // Number of solutions of Kepler's equation
+    unsigned long c_ulKeplerIter;    // Number of iterations for all these solutions
+    
+    Vec3 c_vecSAT, c_vecVEL;      // Celestial coordinates
+    Vec3 c_vecS, c_vecV;          // Geocentric coordinates
+ 
+    P13Satellite(const char *p_ccSatName, const char *p_ccl1, const char *p_ccl2);
+    P13Satellite(const uint8_t *p_aurec, bool p_bprogmem = false);
+    P13Satellite(const P13Satellite &p_sat);
+    ~P13Satellite();
+    
+    P13Satellite &operator=(const P13Satellite &p_sat);
+#ifndef P13_NAME_INLINE
+    P13Satellite(P13Satellite &&p_sat);
+    P13Satellite &operator=(P13Satellite &&p_sat);
+#endif
+    
+    int    tle(const char *p_ccSatName, const char *p_ccl1, const char *p_ccl2);
+    int    load(const uint8_t *p_aurec, bool p_bprogmem = false);
+    void   save(uint8_t *p_aurec) const;
+    void   predict(const P13DateTime &p_dt);
+    void   predictBatch(const P13DateTime *p_adt, size_t p_n, double *p_adlat, double *p_adlon, double *p_adel, double *p_adaz, const P13Observer *p_obs);
+    void   latlon(double &p_dlat, double &p_dlon);
+    void   elaz(const P13Observer &p_obs, double &p_del, double &p_daz);
+    P13State propagate(const P13DateTime &p_dt) const;
+    P13Look  look(const P13State &p_st, const P13Observer &p_obs) const;
+    void   latlon(const P13State &p_st, double &p_dlat, double &p_dlon) const;
+    void   footprint(int p_aipoints[][2], int p_inumberofpoints, const int p_ciMapMaxX, const int p_ciMapMaxY, double &p_dsatlat, double &p_dsatlon);
+    void   footprint(P13Footprint &p_fp, float *p_aflat, float *p_aflon);
+    void   footprint(P13Footprint &p_fp, int p_aipoints[][2], const int p_ciMapMaxX, const int p_ciMapMaxY, uint8_t *p_aubreak = NULL);
+    double footprintRadius();
+    double doppler(double p_dfreqMHz, bool p_bodir);
+    double dopplerOffset(double p_dfreqMHz);
+    bool   nextPass(const P13Observer &p_obs, const P13DateTime &p_dtfrom, P13Pass &p_pass, double p_dminel = 0.0, double p_dmaxdays = 1.0);
+    bool   sunlit(const P13Sun &p_sun);
+    bool   reachable(const P13Observer &p_obs, const P13DateTime &p_dt, double p_dwindow, double p_dminel = 0.0);
+    uint8_t illumination(const P13Sun &p_sun, const P13Observer &p_obs, double p_dminel = 0.0, double p_dtwilight = P13_TWILIGHT);
+    size_t illuminationBatch(const P13DateTime *p_adt, size_t p_n, const P13Observer &p_obs, P13Sun &p_sun, uint8_t *p_auflags, double p_dminel = 0.0, double p_dtwilight = P13_TWILIGHT, double p_dmaxage = P13_SUN_MAXAGE);
+    void   keplerMode(bool p_bwarm, double p_dtol = 1.0E-5);
+    uint8_t engine(uint8_t p_uiengine);
+
+private:
+    // Terms multiplied by the elapsed time (epoch, mean anomaly, mean motion, drag)
+    // are kept in double, see P13Real.
+    long    cp_lN;       // Satellite calaog number
+    long    cp_lYE;      // Epoch Year               year
+    double  cp_dTE;      // Epoch time               days
+    P13Real cp_dIN;      // Inclination              deg
+    P13Real cp_dRA;      // R.A.A.N.                 deg
+    P13Real cp_dEC;      // Eccentricity              -
+    P13Real cp_dWP;      // Arg perigee              deg
+    double  cp_dMA;      // Mean anomaly             deg
+    double  cp_dMM;      // Mean motion              rev/d
+    double  cp_dM2;      // Decay Rate               rev/d/d
+    double  cp_dRV;      // Orbit number              -
+//    double cp_dALON;    // Sat attitude             deg
+//    double cp_dALAT;    // Sat attitude             deg
+    long    cp_lDE;      // Epoch Fraction of day
+    
+    // These values are stored, but could be calculated on the fly during calls to predict() 
+    // Classic space/time tradeoff
+
+    P13Real cp_dN0, cp_dA_0, cp_dB_0;
+    P13Real cp_dPC;
+    P13Real cp_dQD, cp_dWD;
+    double  cp_dDC;
+#ifndef P13_LEAN
+    double  cp_dGHAE;    // GHA Aries, epoch
+    P13Real cp_dCI;      // cos/sin of inclination
+    P13Real cp_dSI;      // -"-
+#endif
+
+    P13Real cp_dRS;      // Radius of satellite orbit
+    P13Real cp_dRR;      // Range rate for doppler calculation
+    P13Real cp_dCG;      // cos/sin of -GHA Aries at the last prediction
+    P13Real cp_dSG;      // -"-
+    
+    bool    cp_bWarm;    // Warm start of Kepler's equation
+    bool    cp_bEA;      // Last solution valid
+    double  cp_dKTol;    // Tolerance for Kepler's equation
+    P13Real cp_dMprev;   // Last solution of Kepler's equation (M, EA, 1-EC*cos(EA))
+    P13Real cp_dEAprev;  // -"-
+    P13Real cp_dDNOMprev;// -"-
+    
+    uint8_t cp_uiEngine; // P13_ENG_...
+#ifdef P13_SGP4
+    P13Sgp4 cp_sgp4;     // Constants of the SGP4 engine
+#endif
+
+    void   copy(const P13Satellite &p_sat);
+    void   clear();
+    void   setElements(const P13Elements &p_el);
+    void   getElements(P13Elements &p_el) const;
+    void   predictElapsed(double p_dT, double p_dGHAE, P13Real p_dCI, P13Real p_dSI);
+    void   elapsedTerms(double p_dT, double p_dGHAE, P13Real &p_dKD, double &p_dM, P13Real &p_dAP, P13Real &p_dRAAN, double &p_dGHAA) const;
+    void   predictState(P13State &p_st, P13Real p_dKD, P13Real p_dC_EA, P13Real p_dS_EA, P13Real p_dDNOM, P13Real p_dCW, P13Real p_dSW, P13Real p_dCQ, P13Real p_dSQ, P13Real p_dCI, P13Real p_dSI, P13Real p_dCG, P13Real p_dSG) const;
+    void   setState(const P13State &p_st);
+    double passel(const P13Observer &p_obs, const P13DateTime &p_dtbase, double p_dt);
+    double passedge(const P13Observer &p_obs, const P13DateTime &p_dtbase, double p_dtbelow, double p_dtabove, double p_dminel);
+    double passmax(const P13Observer &p_obs, const P13DateTime &p_dtbase, double p_dta, double p_dtb);
+#ifdef P13_SGP4
+    bool   sgp4init();
+    bool   sgp4(P13State &p_st, double p_dT) const;
+#endif
+};
+
+
+//----------------------------------------------------------------------
+
+class P13Sun {
+
+public:
+    Vec3 c_vecSUN, c_vecH;
+    
+    P13Sun(uint8_t p_uiengine = P13_SUN_PLAN13);
+    ~P13Sun();
+    
+    void engine(uint8_t p_uiengine);
+    void predict(const P13DateTime &p_dt);
+    bool refresh(const P13DateTime &p_dt, double p_dmaxage = P13_SUN_MAXAGE);
+    void latlon(double &p_dlat, double &p_dlon);
+    void elaz(const P13Observer &p_obs, double &p_del, double &p_daz);
+    void footprint(int p_aipoints[][2], int p_inumberofpoints, const int p_ciMapMaxX, const int p_ciMapMaxY, double &p_dsunlat, double &p_dsunlon);
+    void footprint(P13Footprint &p_fp, float *p_aflat, float *p_aflon);
+    void footprint(P13Footprint &p_fp, int p_aipoints[][2], const int p_ciMapMaxX, const int p_ciMapMaxY, uint8_t *p_aubreak = NULL);
+    double footprintRadius();
+
+private:
+    uint8_t cp_uiEngine; // P13_SUN_...
+    long    cp_lDN;      // Time of the last prediction
+    double  cp_dTN;      // -"-
+    bool    cp_bValid;   // -"- valid
+    
+    double  predictMeeus(long p_lDN, double p_dTN);
+};
+
+
+//----------------------------------------------------------------------
+
+// The moon from the main terms of the lunar series of J. Meeus (Astronomical
+// Algorithms, ch. 47, about 0.02 deg), with the same interface as P13Sun. elaz() is
+// topocentric, the parallax of the moon is up to 1 deg.
+
+class P13Moon {
+
+public:
+    Vec3   c_vecMOON, c_vecH;   // Unit vector, equatorial coordinates of date and geocentric
+    double c_dDist;             // Distance from the center of the earth, km
+    
+    P13Moon();
+    ~P13Moon();
+    
+    void predict(const P13DateTime &p_dt);
+    void predictBatch(const P13DateTime &p_dtstart, double p_dstep, size_t p_n, double *p_adlat, double *p_adlon, double *p_adel, double *p_adaz, const P13Observer *p_obs);
+    void latlon(double &p_dlat, double &p_dlon);
+    void elaz(const P13Observer &p_obs, double &p_del, double &p_daz);
+    void footprint(int p_aipoints[][2], int p_inumberofpoints, const int p_ciMapMaxX, const int p_ciMapMaxY, double &p_dmoonlat, double &p_dmoonlon);
+    void footprint(P13Footprint &p_fp, float *p_aflat, float *p_aflon);
+    void footprint(P13Footprint &p_fp, int p_aipoints[][2], const int p_ciMapMaxX, const int p_ciMapMaxY, uint8_t *p_aubreak = NULL);
+    double footprintRadius();
+
+private:
+    void position(long p_lDN, double p_dTN, Vec3 p_vecP, double &p_dnut);
+};
+
+
+//----------------------------------------------------------------------
+
+// Day/night terminator (grayline) of an equirectangular map as latlon2xy() for
+// the sub-solar point. For each column x the terminator row is stored, rows
+// above it (y < row) are on the day side if northday() is true. Optionally the
+// terminator latitude of each column and a packed 1-bit mask (bit = 1 for day,
+// (MapMaxX + 7) / 8 bytes per row, MSB first as drawBitmap()) are kept. All
+// buffers are given by the caller with MapMaxX elements (mask MapMaxY rows,
+// dirty (MapMaxX + 7) / 8 bytes).
+
+class P13Terminator {
+
+public:
+    int c_iDirtyFirst, c_iDirtyLast;   // Range of the columns changed by the last update() (-1 if none)
+    
+    P13Terminator(int16_t *p_airow, const int p_ciMapMaxX, const int p_ciMapMaxY, float *p_aflat = NULL, uint8_t *p_aumask = NULL, uint8_t *p_audirty = NULL);
+    ~P13Terminator();
+    
+    int  update(P13Sun &p_sun);
+    int  update(double p_dsunlat, double p_dsunlon);
+    int  row(int p_ix);
+    bool northday();
+    bool day(int p_ix, int p_iy);
+    bool dirty(int p_ix);
+    
+private:
+    int16_t *cp_aiRow;
+    float   *cp_afLat;
+    uint8_t *cp_auMask, *cp_auDirty;
+    int      cp_iMaxX, cp_iMaxY;
+    bool     cp_bNorthDay;
+};
+
+
+//----------------------------------------------------------------------
+
+// A catalog of satellites with the elements stored as separate arrays
+// (structure of arrays), so the whole catalog is propagated in one sweep.
+
+class P13Catalog {
+
+public:
+    double *c_adSX, *c_adSY, *c_adSZ;   // Geocentric coordinates
+    double *c_adVX, *c_adVY, *c_adVZ;   // -"-
+    double *c_adRS;                     // Radius of satellite orbit
+    
+    uint16_t c_uiErrFormat;             // Number of rejected TLEs in the last load() or loadRecords()
+    uint16_t c_uiErrChecksum;           // -"-
+    uint16_t c_uiErrFull;               // -"-
+    uint16_t c_uiCulled;                // Number of satellites ruled out by the last prefilter()
+    
+    explicit P13Catalog(uint16_t p_uicapacity);
+    ~P13Catalog();
+    P13Catalog(const P13Catalog &) = delete;    // Owns the arrays, not copyable
+    P13Catalog &operator=(const P13Catalog &) = delete;
+    
+    int         add(const char *p_ccSatName, const char *p_ccl1, const char *p_ccl2);
+    int         add(const P13Satellite &p_sat);
+    void        clear();
+    uint16_t    count();
+    uint16_t    capacity();
+    const char *name(uint16_t p_uiidx);
+    long        number(uint16_t p_uiidx);
+    uint16_t    load(const char *p_ccbuf, size_t p_uilen);
+#ifdef ARDUINO
+    uint16_t    load(Stream &p_stream);
+#endif
+    uint16_t    loadRecords(const uint8_t *p_aurecs, uint16_t p_uicount, bool p_bprogmem = false);
+    
+    void        predict(const P13DateTime &p_dt);
+    void        predict(const P13DateTime &p_dt, uint16_t p_uifirst, uint16_t p_uilast);
+    void        latlon(uint16_t p_uiidx, double &p_dlat, double &p_dlon);
+    void        elaz(uint16_t p_uiidx, const P13Observer &p_obs, double &p_del, double &p_daz);
+    uint16_t    prefilter(const P13Observer &p_obs, const P13DateTime &p_dt, double p_dwindow, double p_dminel = 0.0);
+    uint16_t    visible(const P13Observer &p_obs, const P13DateTime &p_dt, uint16_t *p_auiidx, double *p_adel, double *p_adaz, uint16_t p_uimax, double p_dminel = 0.0);
+
+private:
+    uint16_t cp_uiCap;
+    uint16_t cp_uiCount;
+    
+    char    *cp_acNames;    // Names, P13_NAME_LEN + 1 characters each
+    long    *cp_alN;        // Satellite catalog number
+    long    *cp_alDE;       // Epoch day number
+    double  *cp_adBlock;    // Storage for all double arrays below
+    
+    double  *cp_adTE, *cp_adMA, *cp_adMM, *cp_adDC, *cp_adEC;
+    double  *cp_adN0, *cp_adA_0, *cp_adB_0;
+    double  *cp_adWP, *cp_adWD, *cp_adRA, *cp_adQD;
+    double  *cp_adCI, *cp_adSI, *cp_adGHAE;
+    
+    bool              *cp_abCand;     // Satellite not ruled out by prefilter()
+    const P13Observer *cp_pCullObs;   // Observer, window and min. elevation of the last prefilter()
+    P13DateTime        cp_dtCull0;    // -"-
+    P13DateTime        cp_dtCull1;    // -"-
+    double             cp_dCullMinEl; // -"-
+    
+    const char *cp_ccLdName;    // Pending name and line 1 while loading
+    size_t      cp_uiLdName;
+    const char *cp_ccLdL1;
+    size_t      cp_uiLdL1;
+    uint16_t    cp_uiLdCount;
+    
+    int  store(const char *p_ccnm, size_t p_uinmlen, const P13Elements &p_el);
+    bool loadline(const char *p_ccline, size_t p_uilen);
+};
+
+//----------------------------------------------------------------------
+
+// A set of observers (ground stations) with the station vectors stored as separate
+// arrays (structure of arrays), so one satellite state gives elevation, azimuth,
+// range and range rate for all stations in one loop.
+
+class P13ObserverSet {
+
+public:
+    explicit P13ObserverSet(uint16_t p_uicapacity);
+    ~P13ObserverSet();
+    P13ObserverSet(const P13ObserverSet &) = delete;    // Owns the arrays, not copyable
+    P13ObserverSet &operator=(const P13ObserverSet &) = delete;
+    
+    int         add(const P13Observer &p_obs);
+    void        clear();
+    uint16_t    count();
+    uint16_t    capacity();
+    
+    void        elaz(const P13Satellite &p_sat, double *p_adel, double *p_adaz, double *p_adrange = NULL, double *p_adrr = NULL);
+    void        elaz(const P13Catalog &p_cat, uint16_t p_uiidx, double *p_adel, double *p_adaz, double *p_adrange = NULL, double *p_adrr = NULL);
+    void        elaz(const P13Moon &p_moon, double *p_adel, double *p_adaz, double *p_adrange = NULL);
+
+private:
+    uint16_t cp_uiCap;
+    uint16_t cp_uiCount;
+    
+    P13Real *cp_adBlock;    // Storage for all arrays below
+    
+    P13Real *cp_adOX, *cp_adOY, *cp_adOZ;   // Position (c_vecO)
+    P13Real *cp_adUX, *cp_adUY, *cp_adUZ;   // Up (c_vecU)
+    P13Real *cp_adEX, *cp_adEY;             // East (c_vecE, z = 0)
+    P13Real *cp_adNX, *cp_adNY, *cp_adNZ;   // North (c_vecN)
+    P13Real *cp_adVX, *cp_adVY;             // Velocity (c_vecV, z = 0)
+    
+    void elazState(P13Real p_dSX, P13Real p_dSY, P13Real p_dSZ, P13Real p_dVX, P13Real p_dVY, P13Real p_dVZ, double *p_adel, double *p_adaz, double *p_adrange, double *p_adrr);
+};
+
+
+//----------------------------------------------------------------------
+
+// Fixed step tracking of one satellite. The slowly changing angles (argument of
+// perigee, RAAN, GHA Aries) and the eccentric anomaly are advanced by angle
+// addition instead of calling sin/cos at every step, with a full predict() every
+// "resync" steps.
+
+class P13Tracker {
+
+public:
+    P13DateTime c_dtNow;     // Time of the current state
+    
+    P13Tracker(P13Satellite &p_sat, double p_dstep, uint16_t p_uiresync = 600);
+    ~P13Tracker();
+    
+    void start(const P13DateTime &p_dt);
+    void step();
+
+private:
+    P13Satellite *cp_psat;
+    
+    double   cp_dStep;       // Step, days
+    uint16_t cp_uiResync;    // Steps between full predictions
+    uint16_t cp_uiCount;     // Steps since last full prediction
+    
+    double cp_dT;            // Elapsed T since epoch, days
+    double cp_dGHAE, cp_dCI, cp_dSI;
+    
+    double cp_dCW, cp_dSW, cp_dCWD, cp_dSWD, cp_dCWDD, cp_dSWDD;   // Arg perigee, step, change of step
+    double cp_dCQ, cp_dSQ, cp_dCQD, cp_dSQD, cp_dCQDD, cp_dSQDD;   // RAAN, -"-
+    double cp_dCG, cp_dSG, cp_dCGD, cp_dSGD;                       // -GHA Aries, step
+    
+    double cp_dM, cp_dMOFF;  // Mean anomaly and its offset to the unreduced value
+    double cp_dEA, cp_dC_EA, cp_dS_EA;
+};
+
+//----------------------------------------------------------------------
+
+// Range and range rate of a satellite for an observer at fixed steps, e.g. for
+// a pass, so a rig control can play back the doppler shift during the pass
+// without any prediction. The tables are buffers of the caller with up to max
+// entries: float (range km, range rate km/s) or 16 bit deltas of consecutive
+// entries (P13_DOP_RANGE_LSB, P13_DOP_RR_LSB) for half the memory.
+
+#define P13_DOP_RANGE_LSB  0.01      // Resolution of the 16 bit range deltas, km
+#define P13_DOP_RR_LSB     0.0001    // Resolution of the 16 bit range rate deltas, km/s
+
+class P13DopplerTable {
+
+public:
+    P13DateTime c_dtStart;   // Time of entry 0
+    double      c_dStep;     // Step between entries, s
+    
+    P13DopplerTable(float *p_afrange, float *p_afrr, uint16_t p_uimax);
+    P13DopplerTable(int16_t *p_airange, int16_t *p_airr, uint16_t p_uimax);
+    ~P13DopplerTable();
+    
+    uint16_t build(P13Satellite &p_sat, const P13Observer &p_obs, const P13DateTime &p_dtfrom, const P13DateTime &p_dtto, double p_dstep);
+    uint16_t build(P13Satellite &p_sat, const P13Observer &p_obs, const P13Pass &p_pass, double p_dstep);
+    uint16_t count();
+    void     entry(uint16_t p_uiidx, double &p_drange, double &p_drr);
+    bool     at(const P13DateTime &p_dt, double &p_drange, double &p_drr);
+    double   doppler(double p_dfreqMHz, bool p_bodir);
+    double   dopplerOffset(double p_dfreqMHz);
+
+private:
+    float   *cp_afRange, *cp_afRR;   // Float table
+    int16_t *cp_aiRange, *cp_aiRR;   // Delta table
+    uint16_t cp_uiMax;
+    uint16_t cp_uiCount;
+    
+    double   cp_dRange0, cp_dRR0;    // Entry 0 of the delta table
+    uint16_t cp_uiCur;               // Last decoded entry of the delta table
+    double   cp_dCurRange, cp_dCurRR;
+    
+    double   cp_dRR;                 // Range rate of the last at()
+    
+    bool     store(uint16_t p_uiidx, double p_drange, double p_drr);
+};
+
+//----------------------------------------------------------------------
+
+// Rotator trajectory of a pass: azimuth and elevation of the antenna at fixed steps
+// (buffers of the caller with up to max entries), computed once per pass, so the
+// control loop of a rotator only looks up the table. The azimuth is continuous across
+// 0/360 deg within the azimuth range of the rotator, and both axes are limited to the
+// rates of the rotator. On rotators with an elevation range of 180 deg the pass may be
+// flipped (azimuth + 180, elevation 180 - el), e.g. if it crosses the azimuth stop, or
+// tracked over the top at the fixed azimuth of the pass plane if it goes overhead,
+// whichever the rotator follows best.
+
+#define P13_ROT_NORMAL     0   // Azimuth and elevation as seen by the observer
+#define P13_ROT_FLIP       1   // Whole pass flipped
+#define P13_ROT_OVERHEAD   2   // Fixed azimuth, elevation 0..180 (over the top)
+
+class P13RotatorTable {
+
+public:
+    P13DateTime c_dtStart;   // Time of entry 0
+    double      c_dStep;     // Step between entries, s
+    uint8_t     c_uiMode;    // P13_ROT_... of the last build()
+    double      c_dMaxErr;   // Max. pointing error of the last build(), deg
+    
+    P13RotatorTable(float *p_afaz, float *p_afel, uint16_t p_uimax);
+    ~P13RotatorTable();
+    
+    void     rotator(double p_dazmin, double p_dazmax, double p_delmax, double p_dazrate = 0.0, double p_delrate = 0.0);
+    uint16_t build(P13Satellite &p_sat, const P13Observer &p_obs, const P13Pass &p_pass, double p_dstep);
+    uint16_t count();
+    void     entry(uint16_t p_uiidx, double &p_daz, double &p_del);
+    bool     at(const P13DateTime &p_dt, double &p_daz, double &p_del);
+
+private:
+    float   *cp_afAz, *cp_afEl;
+    uint16_t cp_uiMax;
+    uint16_t cp_uiCount;
+    
+    double   cp_dAzMin, cp_dAzMax;     // Range of the rotator, deg
+    double   cp_dElMax;                // -"-
+    double   cp_dAzRate, cp_dElRate;   // Max. rates of the rotator, deg/s (0: no limit)
+    
+    void     look(P13Satellite &p_sat, const P13Observer &p_obs, uint16_t p_uiidx, double &p_daz, double &p_del);
+    double   sweep(P13Satellite &p_sat, const P13Observer &p_obs, uint16_t p_uin, uint8_t p_uimode, double p_dplane, double p_dshift, bool p_bunwind);
+};
+
+//----------------------------------------------------------------------
+
+// Ephemeris of a satellite for many predictions at arbitrary times: position and
+// velocity are predicted at nodes with a fixed step over a window and interpolated
+// (cubic Hermite) in between. The step follows from the error bound for the
+// position, the window of n nodes (buffers of the caller) slides with the times of
+// the queries and only the nodes new in the window are predicted.
+
+class P13Ephemeris {
+
+public:
+    unsigned long c_ulNodes;     // Number of predicted nodes
+    
+    P13Ephemeris(P13Satellite &p_sat, Vec3 *p_avecs, Vec3 *p_avecv, uint16_t p_uinodes, double p_dmaxerr = 0.01);
+    ~P13Ephemeris();
+    
+    void   predict(const P13DateTime &p_dt);
+    double step();
+    void   invalidate();
+
+private:
+    P13Satellite *cp_psat;
+    
+    Vec3       *cp_avecS, *cp_avecV;   // Nodes: position and its derivative, geocentric
+    uint16_t    cp_uiNodes;
+    double      cp_dMaxErr;            // Error bound, km
+    double      cp_dStep;              // Step between two nodes, days
+    P13DateTime cp_dtBase;             // Time of node 0
+    long        cp_lFirst;             // First node of the window
+    bool        cp_bValid;             // Window valid
+    
+    void node(long p_lk);
+    void rates(const Vec3 p_vecS, const Vec3 p_vecVin, Vec3 p_vecVout, double p_dsign);
+};
+
+//----------------------------------------------------------------------
+
+// Parallel executor for catalog propagation and pass searches: the satellites are
+// split into contiguous blocks of (almost) equal size, one per worker. The blocks only
+// depend on the number of satellites and workers and each satellite is calculated by
+// the same code as in a serial run, so the results are bit-identical. The worker tasks
+// are created per call, the caller works on the first block.
+
+class P13Parallel {
+
+public:
+    P13Parallel(uint8_t p_uiworkers = 2);
+    ~P13Parallel();
+    
+    uint8_t     workers();
+    
+    void        predict(P13Catalog &p_cat, const P13DateTime &p_dt);
+    void        predict(P13Satellite *const p_apsat[], uint16_t p_uicount, const P13DateTime &p_dt);
+    uint16_t    nextPass(P13Satellite *const p_apsat[], uint16_t p_uicount, const P13Observer &p_obs, const P13DateTime &p_dtfrom, P13Pass *p_apass, bool *p_abfound, double p_dminel = 0.0, double p_dmaxdays = 1.0);
+
+private:
+    uint8_t cp_uiWorkers;
+    
+    void run(void (*p_pfjob)(void *p_pvjob, uint16_t p_uifirst, uint16_t p_uilast), void *p_pvjob, uint16_t p_uicount);
+};
+
+//----------------------------------------------------------------------
+
+// Event queue of the passes of a list of satellites over a list of observers. The next
+// pass of each satellite/observer pair is searched with P13Satellite::nextPass() and
+// its AOS, TCA and LOS are kept in a binary heap ordered by time, so the application
+// only has to wake up at the next event instead of polling every satellite. Pass
+// searches are done lazily: after LOS, for pairs without a pass within maxdays at the
+// time of a P13_EV_SEARCH event and for satellites marked with update() at the next
+// call. Like nextPass() the searches leave the satellites in the state at LOS.
+
+#define P13_EV_AOS     0   // Acquisition of signal (in the past for a pass in progress)
+#define P13_EV_TCA     1   // Time of closest approach (max. elevation)
+#define P13_EV_LOS     2   // Loss of signal
+#define P13_EV_SEARCH  3   // No pass within maxdays, search again (no callback)
+
+class P13Event {
+
+public:
+    P13DateTime    c_dtTime;      // Time of the event
+    uint8_t        c_uiType;      // P13_EV_...
+    uint16_t       c_uiSat;       // Index of the satellite and the observer
+    uint16_t       c_uiObs;       // -"-
+    const P13Pass *c_ppass;       // The pass (NULL for P13_EV_SEARCH), valid until the next pass search
+};
+
+typedef void (*P13EventCallback)(const P13Event &p_ev, void *p_pvuser);
+
+struct P13SchedEntry;
+
+class P13Scheduler {
+
+public:
+    P13Scheduler(P13Satellite *const p_apsat[], uint16_t p_uisats, const P13Observer *const p_apobs[], uint16_t p_uiobs, double p_dminel = 0.0, double p_dmaxdays = 1.0);
+    ~P13Scheduler();
+    P13Scheduler(const P13Scheduler &) = delete;    // Owns the passes and the heap, not copyable
+    P13Scheduler &operator=(const P13Scheduler &) = delete;
+    
+    void        callback(P13EventCallback p_pfcb, void *p_pvuser = NULL);
+    void        start(const P13DateTime &p_dt);
+    void        update(uint16_t p_uisat);
+    bool        next(P13Event &p_ev);
+    uint16_t    run(const P13DateTime &p_dtnow);
+    double      sleep(const P13DateTime &p_dtnow);
+
+private:
+    P13Satellite *const      *cp_apSat;
+    const P13Observer *const *cp_apObs;
+    uint16_t          cp_uiSats, cp_uiObs;
+    double            cp_dMinEl, cp_dMaxDays;
+    
+    P13EventCallback  cp_pfCb;
+    void             *cp_pvUser;
+    
+    P13DateTime       cp_dtNow;      // Time of the last start() or run()
+    P13Pass          *cp_apass;      // Next pass of each pair (satellite * observers + observer)
+    bool             *cp_abDirty;    // Pair needs a pass search
+    bool              cp_bDirty;     // -"- any pair
+    
+    P13SchedEntry    *cp_aheap;      // Events, min heap by time, 3 per pair
+    uint32_t          cp_ulHeap;     // Number of events
+    
+    void refresh();
+    void search(uint32_t p_ulpair, const P13DateTime &p_dtfrom);
+    void push(uint32_t p_ulpair, uint8_t p_uitype, const P13DateTime &p_dt);
+    void pop();
+    void down(uint32_t p_uli);
+    void event(const P13SchedEntry &p_en, P13Event &p_ev);
+};
+
+#ifdef P13_PROFILE
+
+//----------------------------------------------------------------------
+
+// Statistics of the profiling hooks, indexed by P13_PROF_... The times are CPU
+// cycles on ESP32, microseconds (micros()) on other boards and nanoseconds on a host.
+
+class P13Profile {
+
+public:
+    static uint32_t c_aulCalls[P13_PROF_COUNT];
+    static uint32_t c_aulMin[P13_PROF_COUNT];
+    static uint32_t c_aulMax[P13_PROF_COUNT];
+    static uint64_t c_aullSum[P13_PROF_COUNT];
+    
+    static uint32_t clock();
+    static void     record(uint8_t p_uiid, uint32_t p_ultime);
+    static void     reset();
+#ifdef ARDUINO
+    static void     dump(Print &p_out);
+#else
+    static void     dump(FILE *p_file);
+#endif
+};
+
+#endif  // P13_PROFILE
+
 #endif  // AioP13_H
\ No newline at end of file